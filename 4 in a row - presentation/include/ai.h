@@ -7,24 +7,114 @@
 #define AI_H
 
 #include "board.h"
+#include "search.h"
+#include "mcts.h"
 
 /* Difficulty levels */
 #define EASY 1
 #define MEDIUM 2
 #define HARD 3
+#define PERFECT 4
+#define MONTE_CARLO 5
+
+/* Default per-move time budget of the Hard AI in milliseconds */
+#define HARD_TIME_LIMIT_MS 500
+
+/* Default number of search threads of the Hard AI */
+#define HARD_THREADS 1
+
+/* Default per-move time budget of the Monte Carlo AI in milliseconds */
+#define MONTE_CARLO_TIME_LIMIT_MS 500
+
+/* Default number of threads sharing the Monte Carlo tree */
+#define MONTE_CARLO_THREADS 1
+
+/* Discs on the board before the Perfect AI solves every move.
+ * Earlier positions can take minutes to solve, so they use the opening
+ * book and the Hard search instead. */
+#define PERFECT_SOLVE_FROM 10
+
+/* Work done by the last AI move of the calling thread */
+typedef struct {
+    long long nodes;             /* Positions visited */
+    long long leafEvaluations;   /* Positions scored by the heuristic */
+    long long cutoffs;           /* Alpha-beta cutoffs */
+    long long firstMoveCutoffs;  /* Cutoffs caused by the first move tried */
+    int depth;                   /* Deepest fully searched depth in plies */
+    int maxDepth;                /* Deepest ply any position was visited at */
+    long long ttProbes;          /* Transposition table lookups */
+    long long ttHits;            /* Lookups that found the position */
+    long long elapsedMicros;     /* Time taken by the move */
+    int fromBook;                /* 1 if the move came from the opening book */
+    long long playouts;          /* Monte Carlo playouts */
+    long long reusedNodes;       /* Monte Carlo nodes kept from the last move */
+    int expectedReply;           /* Opponent move the search expects next (-1 = none) */
+    int pondered;                /* 1 if searched while the opponent was thinking */
+    long long ponderedMicros;    /* Time the reply had been pondered */
+} SearchInfo;
 
 /* Function declarations */
 
+/* Seeds the random numbers of this thread from the clock (once) */
+void initRandomSeed(void);
+
+/* Seeds the random numbers of the calling thread (Easy moves and
+ * Medium fallbacks). Without a call each thread seeds from the clock. */
+void seedRandom(unsigned long long seed);
+
 /* Gets a random valid move (Easy difficulty) */
 int getRandomMove(int board[ROWS][COLS]);
 
+/* Counts player's discs in a row from (row, col) in one direction */
+int countDiscsInDirection(int board[ROWS][COLS], int row, int col,
+                          int rowDir, int colDir, int player);
+
+/* Scores dropping player's disc at (row, col), Medium heuristic */
+int calculatePositionScore(int board[ROWS][COLS], int row, int col, int player);
+
 /* Gets a smart move (Medium difficulty) */
 int getMediumMove(int board[ROWS][COLS], int aiPlayer);
 
 /* Gets best move using minimax (Hard difficulty) */
 int getHardMove(int board[ROWS][COLS], int aiPlayer);
 
+/* Gets the game-theoretically best move (Perfect difficulty) */
+int getPerfectMove(int board[ROWS][COLS], int aiPlayer);
+
+/* Gets a move from Monte Carlo tree search (Monte Carlo difficulty).
+ * Each thread keeps its tree between moves and reuses the part that
+ * is still reachable. */
+int getMonteCarloMove(int board[ROWS][COLS], int aiPlayer);
+
+/* Sets the playout/time budget of the Monte Carlo AI */
+void setMonteCarloLimits(const MctsLimits* limits);
+
+/* Gets the current budget of the Monte Carlo AI */
+void getMonteCarloLimits(MctsLimits* limits);
+
+/* Frees the Monte Carlo tree of the calling thread */
+void releaseMonteCarloTree(void);
+
+/* Sets the time/node/depth budget of the Hard AI */
+void setHardSearchLimits(const SearchLimits* limits);
+
+/* Gets the current budget of the Hard AI */
+void getHardSearchLimits(SearchLimits* limits);
+
 /* Main AI function - selects move based on difficulty */
 int getAIMove(int board[ROWS][COLS], int difficulty, int aiPlayer);
 
+/* Starts pondering: while the human thinks, a background thread
+ * searches the computer's reply to every human move, the move the last
+ * search expected first. Only Hard (and Perfect before it solves) use
+ * it. getAIMove then answers at once for a finished reply and gives a
+ * reply searched in part only the rest of its time budget. */
+void startPondering(int board[ROWS][COLS], int difficulty, int aiPlayer);
+
+/* Stops pondering and waits for the background thread */
+void stopPondering(void);
+
+/* Copies the statistics of the last AI move made on this thread */
+void getLastSearchInfo(SearchInfo* info);
+
 #endif /* AI_H */
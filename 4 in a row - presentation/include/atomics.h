@@ -0,0 +1,90 @@
+/*
+ * atomics.h - Atomic operation header
+ * Minimal portable wrapper around the GCC/Clang __atomic builtins and
+ * the Windows Interlocked functions, for counters and links shared by
+ * threads without a lock
+ *
+ * Plain loads and adds are relaxed: they are never torn, but say
+ * nothing about other memory. A value written with atomicStoreRelease
+ * and read with atomicLoadAcquire also makes everything written before
+ * the store visible to the reader.
+ */
+
+#ifndef ATOMICS_H
+#define ATOMICS_H
+
+#include <stdint.h>
+
+#ifdef _MSC_VER
+#include <windows.h>
+#endif
+
+#ifdef _MSC_VER
+
+/* Reads a shared 32-bit counter */
+static inline uint32_t atomicLoad32(const uint32_t* value) {
+    return *(const volatile uint32_t*)value;
+}
+
+/* Adds to a shared 32-bit counter, returns the value before the add */
+static inline uint32_t atomicAdd32(uint32_t* value, uint32_t amount) {
+    return (uint32_t)InterlockedExchangeAdd((volatile LONG*)value, (LONG)amount);
+}
+
+/* Adds to a shared 64-bit counter, returns the value before the add */
+static inline long long atomicAdd64(long long* value, long long amount) {
+    return InterlockedExchangeAdd64((volatile LONG64*)value, amount);
+}
+
+/* Reads a value published with atomicStoreRelease */
+static inline int32_t atomicLoadAcquire(const int32_t* value) {
+    return (int32_t)InterlockedOr((volatile LONG*)value, 0);
+}
+
+/* Publishes a value together with everything written before it */
+static inline void atomicStoreRelease(int32_t* value, int32_t newValue) {
+    InterlockedExchange((volatile LONG*)value, (LONG)newValue);
+}
+
+/* Replaces expected by desired, returns 1 if the value was expected */
+static inline int atomicCompareExchange(int32_t* value, int32_t expected, int32_t desired) {
+    return InterlockedCompareExchange((volatile LONG*)value, (LONG)desired, (LONG)expected) ==
+           (LONG)expected;
+}
+
+#else
+
+/* Reads a shared 32-bit counter */
+static inline uint32_t atomicLoad32(const uint32_t* value) {
+    return __atomic_load_n(value, __ATOMIC_RELAXED);
+}
+
+/* Adds to a shared 32-bit counter, returns the value before the add */
+static inline uint32_t atomicAdd32(uint32_t* value, uint32_t amount) {
+    return __atomic_fetch_add(value, amount, __ATOMIC_RELAXED);
+}
+
+/* Adds to a shared 64-bit counter, returns the value before the add */
+static inline long long atomicAdd64(long long* value, long long amount) {
+    return __atomic_fetch_add(value, amount, __ATOMIC_RELAXED);
+}
+
+/* Reads a value published with atomicStoreRelease */
+static inline int32_t atomicLoadAcquire(const int32_t* value) {
+    return __atomic_load_n(value, __ATOMIC_ACQUIRE);
+}
+
+/* Publishes a value together with everything written before it */
+static inline void atomicStoreRelease(int32_t* value, int32_t newValue) {
+    __atomic_store_n(value, newValue, __ATOMIC_RELEASE);
+}
+
+/* Replaces expected by desired, returns 1 if the value was expected */
+static inline int atomicCompareExchange(int32_t* value, int32_t expected, int32_t desired) {
+    return __atomic_compare_exchange_n(value, &expected, desired, 0,
+                                       __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE);
+}
+
+#endif
+
+#endif /* ATOMICS_H */
@@ -0,0 +1,230 @@
+/*
+ * bitboard.h - Bitboard position header
+ * Packs a whole board into two 64-bit words for fast search
+ *
+ * Layout: each column uses ROWS + 1 bits, bottom cell first. The extra
+ * bit on top of every column is a sentinel that is never set, so shifts
+ * used for alignment checks can not wrap from one column into the next.
+ *
+ *   .  .  .  .  .  .  .     <- sentinel row
+ *   5 12 19 26 33 40 47
+ *   4 11 18 25 32 39 46
+ *   3 10 17 24 31 38 45
+ *   2  9 16 23 30 37 44
+ *   1  8 15 22 29 36 43
+ *   0  7 14 21 28 35 42     <- bottom row
+ */
+
+#ifndef BITBOARD_H
+#define BITBOARD_H
+
+#include <stdint.h>
+#include "board.h"
+
+/* Bits used by one column (playable cells + sentinel) */
+#define BB_HEIGHT (ROWS + 1)
+
+/* Total number of cells on the board */
+#define BOARD_CELLS (ROWS * COLS)
+
+typedef uint64_t Bitboard;
+
+/* Position seen from the side to move */
+typedef struct {
+    Bitboard current;   /* Discs of the player to move */
+    Bitboard mask;      /* All occupied cells (both players) */
+    uint64_t hash;      /* Zobrist hash, updated on every play/undo */
+    int moves;          /* Number of discs played so far */
+    unsigned char height[COLS];  /* Discs in each column */
+} Position;
+
+/* Hash of the empty board (non-zero so it never looks like an empty
+ * transposition table slot) */
+#define EMPTY_BOARD_HASH 0x6A09E667F3BCC909ULL
+
+/* Zobrist key of a disc: player is 0 for the first mover, 1 for the
+ * second, cell is col * ROWS + height. Keys come from a fixed 64-bit
+ * mixer (splitmix64) so no table has to be built at startup. */
+static inline uint64_t zobristKey(int player, int cell) {
+    uint64_t z = (uint64_t)(cell * 2 + player + 1) * 0x9E3779B97F4A7C15ULL;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+/* Bit of the bottom cell of a column */
+static inline Bitboard bottomMask(int col) {
+    return (Bitboard)1 << (col * BB_HEIGHT);
+}
+
+/* Bit of the top playable cell of a column */
+static inline Bitboard topMask(int col) {
+    return (Bitboard)1 << (ROWS - 1 + col * BB_HEIGHT);
+}
+
+/* All playable cells of a column */
+static inline Bitboard columnMask(int col) {
+    return (((Bitboard)1 << ROWS) - 1) << (col * BB_HEIGHT);
+}
+
+/* Returns 1 if the bitboard contains 4 aligned discs */
+static inline int hasAlignment(Bitboard b) {
+    Bitboard m;
+
+    /* Vertical */
+    m = b & (b >> 1);
+    if (m & (m >> 2)) {
+        return 1;
+    }
+
+    /* Horizontal */
+    m = b & (b >> BB_HEIGHT);
+    if (m & (m >> (2 * BB_HEIGHT))) {
+        return 1;
+    }
+
+    /* Diagonal going down-right */
+    m = b & (b >> (BB_HEIGHT - 1));
+    if (m & (m >> (2 * (BB_HEIGHT - 1)))) {
+        return 1;
+    }
+
+    /* Diagonal going up-right */
+    m = b & (b >> (BB_HEIGHT + 1));
+    if (m & (m >> (2 * (BB_HEIGHT + 1)))) {
+        return 1;
+    }
+
+    return 0;
+}
+
+/* Returns 1 if the column is inside the board and not full */
+static inline int canPlayColumn(const Position* pos, int col) {
+    return col >= 0 && col < COLS && (pos->mask & topMask(col)) == 0;
+}
+
+/* Plays a disc for the side to move (column must be playable) */
+static inline void playColumn(Position* pos, int col) {
+    pos->hash ^= zobristKey(pos->moves & 1, col * ROWS + pos->height[col]);
+    pos->height[col]++;
+    pos->current ^= pos->mask;
+    pos->mask |= pos->mask + bottomMask(col);
+    pos->moves++;
+}
+
+/* Takes back the top disc of a column (must be the last move played) */
+static inline void undoColumn(Position* pos, int col) {
+    pos->moves--;
+    pos->height[col]--;
+    pos->mask ^= bottomMask(col) << pos->height[col];
+    pos->current ^= pos->mask;
+    pos->hash ^= zobristKey(pos->moves & 1, col * ROWS + pos->height[col]);
+}
+
+/* Returns 1 if playing the column wins for the side to move */
+static inline int isWinningMove(const Position* pos, int col) {
+    Bitboard newDisc = (pos->mask + bottomMask(col)) & columnMask(col);
+    return hasAlignment(pos->current | newDisc);
+}
+
+/* Discs of the player who made the last move */
+static inline Bitboard opponentDiscs(const Position* pos) {
+    return pos->current ^ pos->mask;
+}
+
+/* Builds the bottom row mask (folded to a constant by the compiler) */
+static inline Bitboard bottomRowMask(void) {
+    Bitboard b = 0;
+    int col;
+    for (col = 0; col < COLS; col++) {
+        b |= bottomMask(col);
+    }
+    return b;
+}
+
+/* Every playable cell of the board (sentinels excluded) */
+static inline Bitboard fullBoardMask(void) {
+    return bottomRowMask() * ((((Bitboard)1) << ROWS) - 1);
+}
+
+/* Cells where a disc can be dropped right now (one per open column) */
+static inline Bitboard playableCells(const Position* pos) {
+    return (pos->mask + bottomRowMask()) & fullBoardMask();
+}
+
+/* Empty cells that would complete 4 in a row for the given discs */
+static inline Bitboard winningCells(Bitboard discs, Bitboard mask) {
+    Bitboard r, p;
+
+    /* Vertical: three discs right below */
+    r = (discs << 1) & (discs << 2) & (discs << 3);
+
+    /* Horizontal */
+    p = (discs << BB_HEIGHT) & (discs << (2 * BB_HEIGHT));
+    r |= p & (discs << (3 * BB_HEIGHT));
+    r |= p & (discs >> BB_HEIGHT);
+    p = (discs >> BB_HEIGHT) & (discs >> (2 * BB_HEIGHT));
+    r |= p & (discs << BB_HEIGHT);
+    r |= p & (discs >> (3 * BB_HEIGHT));
+
+    /* Diagonal going down-right */
+    p = (discs << (BB_HEIGHT - 1)) & (discs << (2 * (BB_HEIGHT - 1)));
+    r |= p & (discs << (3 * (BB_HEIGHT - 1)));
+    r |= p & (discs >> (BB_HEIGHT - 1));
+    p = (discs >> (BB_HEIGHT - 1)) & (discs >> (2 * (BB_HEIGHT - 1)));
+    r |= p & (discs << (BB_HEIGHT - 1));
+    r |= p & (discs >> (3 * (BB_HEIGHT - 1)));
+
+    /* Diagonal going up-right */
+    p = (discs << (BB_HEIGHT + 1)) & (discs << (2 * (BB_HEIGHT + 1)));
+    r |= p & (discs << (3 * (BB_HEIGHT + 1)));
+    r |= p & (discs >> (BB_HEIGHT + 1));
+    p = (discs >> (BB_HEIGHT + 1)) & (discs >> (2 * (BB_HEIGHT + 1)));
+    r |= p & (discs << (BB_HEIGHT + 1));
+    r |= p & (discs >> (3 * (BB_HEIGHT + 1)));
+
+    return r & (fullBoardMask() ^ mask);
+}
+
+/* Playable moves that do not let the opponent win right away, as a
+ * bitboard of cells. Empty when every move loses. Assumes the side to
+ * move has no immediate win. */
+static inline Bitboard nonLosingMoves(const Position* pos) {
+    Bitboard possible = playableCells(pos);
+    Bitboard opponentWins = winningCells(opponentDiscs(pos), pos->mask);
+    Bitboard forced = possible & opponentWins;
+
+    if (forced) {
+        if (forced & (forced - 1)) {
+            return 0;  /* Two threats at once can not both be blocked */
+        }
+        possible = forced;
+    }
+    /* Never play right below an opponent winning cell */
+    return possible & ~(opponentWins >> 1);
+}
+
+/* Unique key of a position (fits in 49 bits). Inside every column
+ * current + mask can not carry into the next column. */
+static inline uint64_t positionKey(const Position* pos) {
+    return pos->current + pos->mask;
+}
+
+/* Function declarations */
+
+/* Sets position to an empty board */
+void initPosition(Position* pos);
+
+/* Builds a position from a board array, playerToMove owns 'current' */
+void positionFromBoard(Position* pos, int board[ROWS][COLS], int playerToMove);
+
+/* Writes a position back into a board array */
+void positionToBoard(const Position* pos, int board[ROWS][COLS], int playerToMove);
+
+/* Mirrors a bitboard or position key left to right */
+Bitboard mirrorBitboard(Bitboard b);
+
+/* Counts set bits in a bitboard */
+int countBits(Bitboard b);
+
+#endif /* BITBOARD_H */
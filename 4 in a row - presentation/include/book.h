@@ -0,0 +1,52 @@
+/*
+ * book.h - Opening book header
+ * Precomputed best moves for the first plies, memory-mapped from disk
+ *
+ * File layout (native byte order):
+ *   BookHeader
+ *   uint64_t entries[count]   sorted ascending
+ * Each entry is (canonical position key << 8) | best column. The
+ * canonical key is the smaller of a position's key and its mirror's key,
+ * and the stored column belongs to that orientation.
+ */
+
+#ifndef BOOK_H
+#define BOOK_H
+
+#include <stdint.h>
+#include "bitboard.h"
+
+/* Default book file name */
+#define BOOK_FILE "connect4_book.bin"
+
+/* File identification */
+#define BOOK_MAGIC 0x4B4F4234u   /* "4BOK" */
+#define BOOK_VERSION 1
+
+/* File header */
+typedef struct {
+    uint32_t magic;      /* BOOK_MAGIC */
+    uint32_t version;    /* BOOK_VERSION */
+    uint32_t plies;      /* Positions with up to this many discs are stored */
+    uint32_t count;      /* Number of entries */
+} BookHeader;
+
+/* Builds a book entry */
+#define BOOK_ENTRY(key, move) (((uint64_t)(key) << 8) | (uint64_t)(move))
+
+/* Function declarations */
+
+/* Returns the canonical (mirror-independent) key of a position and sets
+ * *mirrored to 1 if the mirror image was used */
+uint64_t canonicalBookKey(const Position* pos, int* mirrored);
+
+/* Maps a book file into memory, returns 1 on success */
+int loadOpeningBook(const char* filename);
+
+/* Unmaps the book */
+void closeOpeningBook(void);
+
+/* Returns the book move for a position, or -1 if it is not in the book */
+int probeOpeningBook(const Position* pos);
+
+#endif /* BOOK_H */
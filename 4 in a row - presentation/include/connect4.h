@@ -0,0 +1,35 @@
+/*
+ * connect4.h - Connect Four engine library header
+ * The one header programs include to use the engine (libconnect4):
+ * board and game rules, AI difficulty levels, search, solver and
+ * opening book. Nothing in the library uses the console or needs a
+ * particular platform; the console game (main.c, ui.c, stats.c) is a
+ * client of this library like the command-line tools are.
+ */
+
+#ifndef CONNECT4_H
+#define CONNECT4_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "board.h"
+#include "game.h"
+#include "bitboard.h"
+#include "ai.h"
+#include "search.h"
+#include "eval.h"
+#include "lines.h"
+#include "transposition.h"
+#include "solver.h"
+#include "book.h"
+#include "timer.h"
+#include "protocol.h"
+#include "connectk.h"
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CONNECT4_H */
@@ -0,0 +1,104 @@
+/*
+ * connectk.h - Connect-K engine header
+ * Gravity games on any board up to 16x16 with any win length K (3-8),
+ * e.g. 9x7 connect-4 or 15x15 connect-5
+ *
+ * A board is stored as multi-word bitboards with the same layout as
+ * bitboard.h: height + 1 bits per column, bottom cell first, the extra
+ * bit is an always-empty sentinel. Rules for one size carry the
+ * precomputed lines (every run of K cells) and the lines through each
+ * cell, so a move only updates the counters of the lines it touches.
+ *
+ * Standard 7x6 connect-4 takes the fast path: the single-word Position
+ * of bitboard.h and the Hard AI search.
+ */
+
+#ifndef CONNECTK_H
+#define CONNECTK_H
+
+#include <stdint.h>
+#include "bitboard.h"
+
+/* Supported sizes */
+#define KBOARD_MIN_SIZE 3
+#define KBOARD_MAX_WIDTH 16
+#define KBOARD_MAX_HEIGHT 16
+#define KBOARD_MIN_K 3
+#define KBOARD_MAX_K 8
+
+/* Cells and bitboard words of the largest board */
+#define KBOARD_MAX_CELLS (KBOARD_MAX_WIDTH * KBOARD_MAX_HEIGHT)
+#define KBOARD_WORDS (((KBOARD_MAX_HEIGHT + 1) * KBOARD_MAX_WIDTH + 63) / 64)
+
+/* Most lines on a board (16x16 with K = 3) and through one cell */
+#define KBOARD_MAX_LINES 840
+#define KBOARD_MAX_CELL_LINES (4 * KBOARD_MAX_K)
+
+/* Search scores: wins are KWIN_SCORE minus the discs played */
+#define KWIN_SCORE 1000000
+#define KWIN_THRESHOLD (KWIN_SCORE - KBOARD_MAX_CELLS - 1)
+
+/* Bitboard spanning several 64-bit words */
+typedef struct {
+    uint64_t w[KBOARD_WORDS];
+} KBitboard;
+
+/* Board size, win length and the line tables for that size */
+typedef struct {
+    int width;
+    int height;
+    int k;
+    int cells;                 /* width * height */
+    int words;                 /* 64-bit words used by a bitboard */
+    int fastPath;              /* 1 for 7x6 with K = 4 */
+    int lineCount;
+    unsigned short lines[KBOARD_MAX_LINES][KBOARD_MAX_K];   /* Cells of each line */
+    unsigned short cellLines[KBOARD_MAX_CELLS][KBOARD_MAX_CELL_LINES];
+    unsigned char cellLineCount[KBOARD_MAX_CELLS];
+    int lineWeight[KBOARD_MAX_K + 1];  /* Score of a line by disc count */
+    int order[KBOARD_MAX_WIDTH];       /* Columns, center first */
+} ConnectKRules;
+
+/* A game in progress (cell = col * height + row, row 0 at the bottom) */
+typedef struct {
+    const ConnectKRules* rules;
+    KBitboard discs[2];        /* Discs of the first (0) and second (1) mover */
+    unsigned char heights[KBOARD_MAX_WIDTH];
+    int moves;
+    unsigned char lineDiscs[2][KBOARD_MAX_LINES];  /* Discs per player per line */
+    int score;                 /* Sum of line scores for the first mover */
+    Position fast;             /* Same game as a Position on the fast path */
+} ConnectKGame;
+
+/* Function declarations */
+
+/* Sets up rules and line tables for a size, returns 0 if unsupported */
+int initConnectKRules(ConnectKRules* rules, int width, int height, int k);
+
+/* Starts a game on an empty board */
+void initConnectKGame(ConnectKGame* game, const ConnectKRules* rules);
+
+/* Returns 1 if a disc can be dropped in the column */
+int connectKCanPlay(const ConnectKGame* game, int col);
+
+/* Returns 1 if dropping in the column wins for the side to move */
+int connectKIsWinningMove(const ConnectKGame* game, int col);
+
+/* Drops a disc for the side to move, returns GAME_ONGOING, GAME_WIN
+ * (the mover won) or GAME_TIE */
+int connectKPlay(ConnectKGame* game, int col);
+
+/* Takes back the top disc of a column (must be the last move) */
+void connectKUndo(ConnectKGame* game, int col);
+
+/* Returns 1 if player (0 = first mover) has K in a row anywhere
+ * (multi-word bitboard shifts, no line tables). The engine wins by the
+ * line counters; this independent check is what kplay verifies them with */
+int connectKHasAlignment(const ConnectKGame* game, int player);
+
+/* Alpha-beta search to a fixed depth, returns the best column and
+ * writes its score for the side to move (the fast path answers a
+ * forced move at once with score 0, like the Hard AI) */
+int searchConnectK(ConnectKGame* game, int depth, int* score, long long* nodes);
+
+#endif /* CONNECTK_H */
@@ -0,0 +1,45 @@
+/*
+ * eval.h - Position evaluation header
+ * Incremental window evaluation used at the search horizon
+ *
+ * The board has 69 windows of four cells in a row (24 horizontal,
+ * 21 vertical, 24 diagonal), the lines of the generated tables in
+ * lines.h. The evaluator keeps how many discs each player has in every
+ * line and a running total of the window scores, updated by the search
+ * on every make/unmake. A leaf then only adds the threat bonus, which
+ * is a fixed number of bitboard operations.
+ */
+
+#ifndef EVAL_H
+#define EVAL_H
+
+#include "bitboard.h"
+#include "lines.h"
+
+/* Evaluations are kept inside +-EVAL_LIMIT so they never look like wins */
+#define EVAL_LIMIT 500
+
+/* Window counters of one position */
+typedef struct {
+    LineCounts lines;      /* Discs per player (0 = first mover) */
+    int score;             /* Window score for the first mover */
+} Evaluator;
+
+/* Function declarations */
+
+/* Builds the window score table (called before the first search) */
+void initEvaluationTables(void);
+
+/* Sets the counters from a position */
+void initEvaluator(Evaluator* eval, const Position* pos);
+
+/* Adds a disc of player (0 = first mover) on cell col * ROWS + height */
+void evalAddDisc(Evaluator* eval, int player, int cell);
+
+/* Takes back a disc added with evalAddDisc */
+void evalRemoveDisc(Evaluator* eval, int player, int cell);
+
+/* Evaluates a position for the side to move (horizon heuristic) */
+int evaluateBoardState(const Evaluator* eval, const Position* pos);
+
+#endif /* EVAL_H */
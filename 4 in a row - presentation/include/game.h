@@ -27,7 +27,13 @@ int checkDiagonal(int board[ROWS][COLS], int player);
 /* Checks if a player has won */
 int checkWin(int board[ROWS][COLS], int player);
 
+/* Checks if the disc just placed at (row, col) wins for player */
+int checkWinAt(int board[ROWS][COLS], int row, int col, int player);
+
 /* Checks game state: ongoing, win, or tie */
 int getGameState(int board[ROWS][COLS], int lastPlayer);
 
+/* Checks game state using only the lines through the last move */
+int getGameStateAfterMove(int board[ROWS][COLS], int row, int col, int player);
+
 #endif /* GAME_H */
@@ -0,0 +1,146 @@
+/*
+ * gamelog.h - Game log header
+ * Append-only file with one record per finished game: the moves, the
+ * result, the mode, the difficulty and when the game started and ended.
+ * Records are only ever added at the end, so saving a game costs one
+ * record and the whole history can be replayed.
+ *
+ * Record layout (native byte order):
+ *   GameRecordHeader       length = size of the whole record
+ *   uint8_t moves[moveCount]   columns 0-6
+ *   uint32_t checksum      FNV-1a of the header and moves
+ * A record cut short by a crash fails its length or checksum test; the
+ * log is cut back to the last whole record when it is opened. Bad
+ * bytes that are not such a cut-off last record are never cut off: the
+ * log is damaged, and stats.c moves it aside instead.
+ *
+ * Statistics are not stored per game: stats.c rebuilds them from a
+ * checkpoint (counts plus the log size they include) and the records
+ * after it.
+ *
+ * Packed records (archives of many games) store each move in 3 bits:
+ *   byte 0   moveCount (bits 0-5) | winner << 6
+ *   byte 1   mode (bits 0-1) | difficulty << 2
+ *   moves    3 bits per move, first move in the lowest bits
+ * A full 42-move game takes 2 + 16 bytes. An archive file is a
+ * PackedArchiveHeader followed by packed records.
+ */
+
+#ifndef GAMELOG_H
+#define GAMELOG_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include "board.h"
+
+/* Default log file name */
+#define GAME_LOG_FILE "connect4_games.log"
+
+#define GAME_LOG_VERSION 1
+
+/* Packed records and archive files */
+#define PACKED_RECORD_MAX_SIZE (2 + (ROWS * COLS * 3 + 7) / 8)
+#define ARCHIVE_MAGIC 0x4B504334u   /* "4CPK" */
+#define ARCHIVE_VERSION 1
+
+/* Game modes */
+#define MODE_PVP 1
+#define MODE_PVC 2
+
+/* What follows the last whole record of a log (checkGameLogTail) */
+#define LOG_TAIL_CLEAN 0      /* Nothing */
+#define LOG_TAIL_TORN 1       /* The start of one record, cut off at end of file */
+#define LOG_TAIL_DAMAGED 2    /* Bytes that are not a record, or more after them */
+
+/* Records between fsync calls (every record is flushed to the OS) */
+#define GAME_LOG_SYNC_INTERVAL 8
+
+/* Fixed part of a record */
+typedef struct {
+    uint16_t length;       /* Bytes in the whole record */
+    uint8_t version;       /* GAME_LOG_VERSION */
+    uint8_t mode;          /* MODE_PVP or MODE_PVC */
+    uint8_t difficulty;    /* Computer level in PvC, 0 in PvP */
+    uint8_t winner;        /* PLAYER1, PLAYER2 or EMPTY for a tie */
+    uint8_t moveCount;
+    uint8_t reserved;
+    int64_t startTime;     /* Seconds since 1970 */
+    int64_t endTime;
+} GameRecordHeader;
+
+/* A game as the program keeps it */
+typedef struct {
+    int mode;
+    int difficulty;
+    int winner;
+    int moveCount;
+    long long startTime;
+    long long endTime;
+    unsigned char moves[ROWS * COLS];
+} GameRecord;
+
+/* Archive file header */
+typedef struct {
+    uint32_t magic;        /* ARCHIVE_MAGIC */
+    uint32_t version;      /* ARCHIVE_VERSION */
+} PackedArchiveHeader;
+
+/* An open log */
+typedef struct {
+    FILE* file;
+    int unsynced;          /* Records written since the last fsync */
+} GameLog;
+
+/* Called for every record read from a log */
+typedef void (*GameRecordHandler)(const GameRecord* record, void* context);
+
+/* Function declarations */
+
+/* FNV-1a checksum of a byte range (records and stats checkpoints) */
+uint32_t checksumBytes(const void* data, size_t length);
+
+/* Starts a record for a new game (start time is now) */
+void beginGameRecord(GameRecord* record, int mode, int difficulty);
+
+/* Reads the whole records from a byte offset on, returns the offset
+ * after the last whole record (the offset itself if there are none) */
+long long readGameLog(const char* filename, long long offset,
+                      GameRecordHandler handler, void* context);
+
+/* Tells what follows the last whole record (end, as returned by
+ * readGameLog): LOG_TAIL_CLEAN, LOG_TAIL_TORN or LOG_TAIL_DAMAGED */
+int checkGameLogTail(const char* filename, long long end);
+
+/* Opens a log for appending at end (offset returned by readGameLog) and
+ * cuts off a torn last record, returns 1 on success. Returns 0 and
+ * leaves the file alone if there is anything else after end. */
+int openGameLog(GameLog* log, const char* filename, long long end);
+
+/* Appends a record (end time is now), returns 1 on success */
+int appendGameRecord(GameLog* log, GameRecord* record);
+
+/* Returns the log size in bytes (the offset of the next record) */
+long long getGameLogSize(const GameLog* log);
+
+/* Forces the records written so far onto the disk */
+void syncGameLog(GameLog* log);
+
+/* Syncs and closes the log */
+void closeGameLog(GameLog* log);
+
+/* Packs a record (no times) into out, returns the bytes written */
+int packGameRecord(const GameRecord* record, unsigned char* out);
+
+/* Size of the packed record that starts with this byte */
+int packedRecordSize(unsigned char firstByte);
+
+/* Unpacks a record from at most available bytes, returns the bytes
+ * used, 0 if the record is cut short or -1 if it can not be a record */
+int unpackGameRecord(const unsigned char* in, int available, GameRecord* record);
+
+/* Plays a record's moves on a bitboard, returns the result they lead to
+ * (PLAYER1, PLAYER2, EMPTY for a full board) or -1 if a move is illegal,
+ * comes after a win or the game is not finished */
+int replayGameRecord(const GameRecord* record);
+
+#endif /* GAMELOG_H */
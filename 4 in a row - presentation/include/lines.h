@@ -0,0 +1,59 @@
+/*
+ * lines.h - Winning line tables header
+ * Every line of four cells on the board, the lines through each cell
+ * and the cells along each direction from a cell, plus the per-line
+ * disc counters the evaluator keeps. A win check or a move score then looks at the handful of
+ * lines through one cell instead of walking the board.
+ *
+ * The tables are generated by tools/linegen.c into src/linetables.c;
+ * make regenerates that file when the generator or the board size
+ * changes.
+ *
+ * Two cell numberings are used:
+ *   cell         col * ROWS + height (bitboard, evaluator and Zobrist order)
+ *   board index  row * COLS + col (the board array read as one row)
+ * Lines are stored in direction groups: horizontal, vertical (down),
+ * diagonal (down-right) and anti-diagonal (up-right), each group in
+ * board order of its first cell.
+ */
+
+#ifndef LINES_H
+#define LINES_H
+
+#include "bitboard.h"
+
+/* Lines of four cells on the board and where each direction starts */
+#define LINE_COUNT 69
+#define FIRST_HORIZONTAL_LINE 0
+#define FIRST_VERTICAL_LINE 24
+#define FIRST_DIAGONAL_LINE 45
+#define FIRST_ANTIDIAGONAL_LINE 57
+
+/* Most lines through a single cell */
+#define MAX_CELL_LINES 13
+
+/* Longest ray from a cell to the edge of the board */
+#define MAX_RAY_LENGTH 6
+
+/* Ray slots per cell: one per (rowDir, colDir) pair, the middle one
+ * (0, 0) is always empty */
+#define DIRECTION_SLOTS 9
+#define DIRECTION_INDEX(rowDir, colDir) (((rowDir) + 1) * 3 + (colDir) + 1)
+
+/* Numbers of board[row][col] */
+#define BOARD_CELL(row, col) ((col) * ROWS + ROWS - 1 - (row))
+#define BOARD_INDEX(row, col) ((row) * COLS + (col))
+
+/* Generated tables (src/linetables.c) */
+extern const unsigned char g_lineBoardIndex[LINE_COUNT][4];    /* Board indexes of each line */
+extern const unsigned char g_cellLines[BOARD_CELLS][MAX_CELL_LINES];
+extern const unsigned char g_cellLineCount[BOARD_CELLS];
+extern const unsigned char g_boardRays[BOARD_CELLS][DIRECTION_SLOTS][MAX_RAY_LENGTH];
+extern const unsigned char g_boardRayLength[BOARD_CELLS][DIRECTION_SLOTS];
+
+/* Discs of each side in every line */
+typedef struct {
+    unsigned char discs[2][LINE_COUNT];  /* [0] = PLAYER1 / first mover */
+} LineCounts;
+
+#endif /* LINES_H */
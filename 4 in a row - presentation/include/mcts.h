@@ -0,0 +1,124 @@
+/*
+ * mcts.h - Monte Carlo tree search header
+ * UCT search used by the Monte Carlo AI
+ *
+ * Every iteration walks down the tree by the UCT rule, expands the leaf
+ * it reaches, finishes the game from there with a quick playout and
+ * adds the result to every node on the way back up. The more playouts
+ * a move gets, the stronger it plays, so strength follows the budget.
+ *
+ * Playouts and expansion are lightly guided: a side that can win at
+ * once does, a single opponent threat is blocked, and moves right below
+ * an opponent winning cell are avoided while others exist.
+ *
+ * Nodes come from a fixed pool, children of a node are one block of
+ * it. The tree is kept after a move: when the next search starts one
+ * or two plies further down, that subtree is copied into the second
+ * pool and searched on from there.
+ *
+ * Several threads can search one tree at once (tree parallelism). Visit
+ * and reward counters are updated atomically, and a thread on its way
+ * down already counts a visit without a reward in every node it passes
+ * (virtual loss), so the next thread sees that branch as worse and
+ * tends to pick another one. A leaf is expanded by the first thread to
+ * claim it with a compare-and-swap; the others play out from the leaf
+ * meanwhile instead of waiting.
+ */
+
+#ifndef MCTS_H
+#define MCTS_H
+
+#include "bitboard.h"
+
+/* Default pool size in nodes (16 bytes each, two pools per tree) */
+#define MCTS_DEFAULT_POOL_NODES (1 << 20)
+
+/* Most threads a search may use */
+#define MCTS_MAX_THREADS 64
+
+/* Visits a thread adds to each node on its way down, counted as losses
+ * until its result arrives (one of them becomes the real visit) */
+#define MCTS_VIRTUAL_LOSS 1
+
+/* UCT exploration constant (results are 0, 0.5 and 1) */
+#define MCTS_EXPLORATION 1.0
+
+/* Playouts used when a search is given no budget at all */
+#define MCTS_DEFAULT_PLAYOUTS 100000
+
+/* Terminal state of a node, seen from the player who moved into it */
+#define MCTS_OPEN 0
+#define MCTS_WIN 1
+#define MCTS_DRAW 2
+
+/* firstChild of a leaf whose children are being created */
+#define MCTS_EXPANDING (-2)
+
+/* A node: the position after its move */
+typedef struct {
+    uint32_t visits;       /* Including playouts still under way */
+    uint32_t reward;       /* Half points of the player who moved into it
+                              (2 per win, 1 per draw) */
+    int32_t firstChild;    /* Pool index of the first child, -1 = leaf,
+                              MCTS_EXPANDING while a thread creates them */
+    uint8_t childCount;
+    uint8_t move;          /* Column played into this node */
+    uint8_t terminal;      /* MCTS_OPEN, MCTS_WIN or MCTS_DRAW */
+    uint8_t reserved;
+} MctsNode;
+
+/* A search tree with its node pools. The root is always node 0. */
+typedef struct {
+    MctsNode* nodes;       /* Pool in use */
+    MctsNode* spare;       /* Pool a reused subtree is copied into */
+    int capacity;          /* Nodes per pool */
+    int32_t used;          /* Nodes taken from the pool in use */
+    int hasRoot;           /* 0 until the first search */
+    Position rootPos;      /* Position at the root */
+    uint64_t random;       /* Playout random numbers (xorshift64) */
+} MctsTree;
+
+/* Budget for one move, a zero field means "no limit" */
+typedef struct {
+    long long playoutLimit;  /* Playouts per move */
+    long timeLimitMs;        /* Wall-clock budget per move */
+    int threads;             /* Threads sharing the tree, 1 = single-threaded */
+    volatile int* stop;      /* Raised by another thread to stop early */
+} MctsLimits;
+
+/* Outcome of a search */
+typedef struct {
+    int bestMove;            /* Most visited root move (-1 if board is full) */
+    double winRate;          /* Its average result, 0 = loss, 1 = win */
+    long long playouts;      /* Playouts of this search */
+    long long elapsedMicros;
+    double playoutsPerSecond;
+    int treeNodes;           /* Nodes in the tree after the search */
+    int reusedNodes;         /* Nodes kept from the previous search */
+    long long reusedVisits;  /* Root visits kept from the previous search */
+    int maxDepth;            /* Deepest node reached in plies */
+    int poolFull;            /* 1 if the pool ran out of nodes */
+    int threads;             /* Threads that took part */
+} MctsResult;
+
+/* Function declarations */
+
+/* Allocates both pools, returns 1 on success (playouts seeded with 1) */
+int initMctsTree(MctsTree* tree, int capacity);
+
+/* Releases the pools */
+void freeMctsTree(MctsTree* tree);
+
+/* Forgets the tree, the next search starts from scratch */
+void clearMctsTree(MctsTree* tree);
+
+/* Seeds the playout random numbers */
+void seedMctsTree(MctsTree* tree, unsigned long long seed);
+
+/* Searches a position within the limits and returns the best move.
+ * The tree of the previous search is reused if pos follows from it.
+ * With limits->threads > 1 helper threads search the same tree. */
+int searchMcts(MctsTree* tree, const Position* pos, const MctsLimits* limits,
+               MctsResult* result);
+
+#endif /* MCTS_H */
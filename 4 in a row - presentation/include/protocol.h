@@ -0,0 +1,36 @@
+/*
+ * protocol.h - Engine text protocol header
+ * Reads commands line by line and writes plain-text answers, so other
+ * programs can drive the AI through a pipe (no screen clearing, no colors)
+ *
+ * Commands:
+ *   newgame                  empty board, forget earlier searches
+ *   position [moves]         board after the given moves, columns 1-7
+ *                            (e.g. "position 4453"; no moves = empty board)
+ *   go [depth N] [movetime MS] [nodes N] [threads N] [infinite]
+ *                            searches in the background and answers
+ *                            "info ..." and "bestmove C" when done;
+ *                            "infinite" runs until "stop" or the
+ *                            next position, go or newgame
+ *   stop                     ends the running search, which still answers
+ *   isready                  answers "readyok"
+ *   quit                     ends the engine
+ *
+ * Commands are handled in order: position, go and newgame wait for the
+ * running search to answer first (an infinite search is stopped, as it
+ * is at end of input). Answers to bad input start with
+ * "error"; go values must be whole numbers of 0 or more. Without limits
+ * "go" uses the Hard AI time budget.
+ */
+
+#ifndef PROTOCOL_H
+#define PROTOCOL_H
+
+#include <stdio.h>
+
+/* Function declarations */
+
+/* Runs the command loop until "quit" or end of input, returns 0 */
+int runEngineProtocol(FILE* input, FILE* output);
+
+#endif /* PROTOCOL_H */
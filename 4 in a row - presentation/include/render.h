@@ -0,0 +1,49 @@
+/*
+ * render.h - Frame renderer header
+ * The console UI composes each screen (title, board, prompts) into a
+ * grid of characters and colors, and the renderer sends it with ANSI
+ * escape codes in a single write. It keeps a copy of what the terminal
+ * shows, so a new frame only sends cursor moves and characters for the
+ * cells that changed (one disc and the status line between turns). The
+ * whole screen is redrawn only at the start and after a resize.
+ */
+
+#ifndef RENDER_H
+#define RENDER_H
+
+/* Output buffer size, a fuller buffer is written out early */
+#define FRAME_BUFFER_SIZE 16384
+
+/* Largest screen area the renderer tracks (text beyond it is cut) */
+#define SCREEN_MAX_ROWS 64
+#define SCREEN_MAX_COLS 128
+
+/* Render modes */
+#define RENDER_DIFF 0    /* Send only changed cells (default) */
+#define RENDER_FULL 1    /* Rewrite every line of every frame */
+
+/* Function declarations */
+
+/* Prepares the terminal (ANSI codes on Windows), the first frame
+ * clears the whole screen */
+void initRenderer(void);
+
+/* Selects RENDER_DIFF or RENDER_FULL */
+void setRenderMode(int mode);
+
+/* Starts a new frame at the top left corner of the screen */
+void beginFrame(void);
+
+/* Switches the text color (Windows console color number, 7 = default) */
+void frameColor(int color);
+
+/* Appends formatted text to the frame */
+void framePrintf(const char* format, ...);
+
+/* Sends the changes with one system call */
+void flushFrame(void);
+
+/* Tells the renderer the terminal echoed a line of input at the cursor */
+void frameInputEchoed(void);
+
+#endif /* RENDER_H */
@@ -0,0 +1,90 @@
+/*
+ * search.h - Alpha-beta search header
+ * Iterative-deepening minimax used by the Hard AI
+ */
+
+#ifndef SEARCH_H
+#define SEARCH_H
+
+#include "bitboard.h"
+#include "eval.h"
+
+/* Search scores */
+#define WIN_SCORE 1000
+#define INFINITE_SCORE 10000
+
+/* Scores above this are wins (heuristic scores stay far below it) */
+#define WIN_THRESHOLD (WIN_SCORE - 100)
+
+/* Budget for one move, a zero field means "no limit" */
+typedef struct {
+    int maxDepth;            /* Deepest iteration in plies */
+    long timeLimitMs;        /* Wall-clock budget per move */
+    long long nodeLimit;     /* Node budget per move (main thread) */
+    int threads;             /* Search threads, 1 = single-threaded */
+    volatile int* stop;      /* Raised by another thread to end the search
+                                early (NULL = never) */
+} SearchLimits;
+
+/* Most threads a search may use */
+#define MAX_SEARCH_THREADS 64
+
+/* Outcome of a search */
+typedef struct {
+    int bestMove;            /* Column to play (-1 if board is full) */
+    int score;               /* Score for the side to move */
+    int depth;               /* Deepest fully completed iteration */
+    long long nodes;         /* Nodes visited by all threads */
+    long long elapsedMicros; /* Wall-clock time used */
+    int threads;             /* Threads that took part */
+    long long cutoffs;       /* Beta cutoffs of the main thread */
+    long long firstMoveCutoffs;  /* Cutoffs caused by the first move tried */
+    long long leafEvaluations;   /* Horizon evaluations by all threads */
+    int maxPly;              /* Deepest ply any node was visited at */
+    long long ttProbes;      /* Transposition table lookups by all threads */
+    long long ttHits;        /* Lookups that found the position */
+    int pv[BOARD_CELLS];     /* Principal variation, starting with bestMove */
+    int pvLength;            /* Moves in pv */
+} SearchResult;
+
+/* State shared by all nodes of one search */
+typedef struct {
+    int maxDepth;            /* Depth of the running iteration */
+    long long nodes;         /* Nodes visited so far */
+    long long nodeLimit;     /* Stop after this many nodes (0 = none) */
+    long long deadline;      /* Stop at this time stamp in us (0 = none) */
+    int stopped;             /* Set once a budget has run out */
+    volatile int* sharedStop;  /* Raised to stop this thread (the caller's
+                                  flag, or the main thread's for helpers) */
+    long long ttProbes;      /* Transposition table lookups */
+    long long ttHits;        /* Lookups that found the position */
+    long long cutoffs;       /* Beta cutoffs */
+    long long firstMoveCutoffs;  /* Beta cutoffs by the first move tried */
+    long long leafEvaluations;   /* Calls of evaluateBoardState */
+    int maxPly;              /* Deepest ply visited */
+    int killers[BOARD_CELLS + 1][2];  /* Two cutoff moves per ply */
+    int history[2][BOARD_CELLS];      /* Cutoff score per side and cell */
+    int moveStack[BOARD_CELLS];  /* Columns played in the search, for undo */
+    int stackSize;           /* Moves on the stack (= current ply) */
+    Evaluator eval;          /* Window counters, kept in step with the position */
+} SearchContext;
+
+/* Function declarations */
+
+/* Plays a move in place, pushes it on the undo stack and updates the
+ * evaluator */
+void makeMove(SearchContext* ctx, Position* pos, int col);
+
+/* Takes back the last move on the undo stack */
+void unmakeMove(SearchContext* ctx, Position* pos);
+
+/* Minimax with alpha-beta pruning and transposition table (negamax form) */
+int minimaxAlgorithm(SearchContext* ctx, Position* pos, int depth, int alpha, int beta);
+
+/* Searches depth 1, 2, 3... until the limits run out and returns the
+ * best move of the deepest completed iteration. With limits->threads > 1
+ * helper threads search the same root (Lazy SMP) and share the
+ * transposition table; the answer is always the main thread's. */
+int searchPosition(const Position* pos, const SearchLimits* limits, SearchResult* result);
+
+#endif /* SEARCH_H */
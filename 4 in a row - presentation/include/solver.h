@@ -0,0 +1,53 @@
+/*
+ * solver.h - Connect Four solver header
+ * Searches to the end of the game and returns the exact result
+ *
+ * Scores follow the usual solver convention, from the side to move:
+ *   0   draw
+ *   >0  win; the higher, the sooner (22 - discs the winner still needs)
+ *   <0  loss; the lower, the sooner
+ */
+
+#ifndef SOLVER_H
+#define SOLVER_H
+
+#include "bitboard.h"
+
+/* Best and worst possible scores */
+#define SOLVER_MAX_SCORE ((BOARD_CELLS + 1) / 2 - 3)
+#define SOLVER_MIN_SCORE (-(BOARD_CELLS) / 2 + 3)
+
+/* Score marking a column that can not be played */
+#define INVALID_SOLVER_SCORE (-1000)
+
+/* Game-theoretic outcome for the side to move */
+#define SOLVE_LOSS -1
+#define SOLVE_DRAW 0
+#define SOLVE_WIN 1
+
+/* Exact result of a position */
+typedef struct {
+    int score;           /* Solver score (see above) */
+    int outcome;         /* SOLVE_WIN, SOLVE_DRAW or SOLVE_LOSS */
+    int pliesToEnd;      /* Plies until the game ends, winning disc included */
+    int bestMove;        /* Column reaching the score (-1 if board full) */
+    long long nodes;     /* Nodes searched */
+} SolveResult;
+
+/* Function declarations */
+
+/* Solves a position exactly (null-window search on a bitboard) */
+int solve(const Position* pos, SolveResult* result);
+
+/* Exact score of every column, INVALID_SOLVER_SCORE for full columns */
+void solveAllMoves(const Position* pos, int scores[COLS]);
+
+/* Allocates the solver's transposition table, returns 1 on success.
+ * solve() does this on first use; call it first when several threads
+ * are going to solve at the same time. */
+int initSolver(void);
+
+/* Empties the solver's transposition table */
+void resetSolver(void);
+
+#endif /* SOLVER_H */
@@ -6,6 +6,16 @@
 #ifndef STATS_H
 #define STATS_H
 
+#include <stdint.h>
+#include "gamelog.h"
+
+/* Games between checkpoints (the log tail replayed at startup) */
+#define STATS_CHECKPOINT_INTERVAL 64
+
+/* Checkpoint file identification */
+#define STATS_MAGIC 0x54534334u   /* "4CST" */
+#define STATS_VERSION 2
+
 /* Statistics structure */
 typedef struct {
     int player1Wins;      /* Wins for player 1 */
@@ -16,6 +26,15 @@ typedef struct {
     int totalGames;       /* Total games played */
 } GameStats;
 
+/* Checkpoint file: the counts and how much of the log they include */
+typedef struct {
+    uint32_t magic;       /* STATS_MAGIC */
+    uint32_t version;     /* STATS_VERSION */
+    GameStats stats;
+    int64_t logOffset;    /* Log bytes already counted */
+    uint32_t checksum;    /* FNV-1a of the fields above */
+} StatsCheckpoint;
+
 /* Function declarations */
 
 /* Initializes statistics to zero */
@@ -30,10 +49,21 @@ void updatePvCStats(GameStats* stats, int humanWon);
 /* Displays all statistics */
 void displayStats(GameStats* stats);
 
-/* Saves statistics to file */
-void saveStats(GameStats* stats, const char* filename);
+/* Rebuilds statistics from a checkpoint and the game log records after
+ * it, and opens the log for new games. Returns 0 if the log is damaged
+ * (not just a torn last record): it is then renamed, see below. */
+int loadStats(GameStats* stats, const char* checkpointFile, const char* logFile);
+
+/* Returns the name loadStats moved a damaged log to, NULL if none */
+const char* getDamagedLogFile(void);
+
+/* Logs a finished game and counts it */
+void recordGame(GameStats* stats, GameRecord* record);
+
+/* Writes a checkpoint of the statistics */
+void saveStats(const GameStats* stats);
 
-/* Loads statistics from file */
-void loadStats(GameStats* stats, const char* filename);
+/* Writes a checkpoint and closes the log */
+void closeStats(const GameStats* stats);
 
 #endif /* STATS_H */
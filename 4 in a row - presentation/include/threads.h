@@ -0,0 +1,44 @@
+/*
+ * threads.h - Thread helper header
+ * Minimal portable wrapper around Windows threads and pthreads
+ */
+
+#ifndef THREADS_H
+#define THREADS_H
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <pthread.h>
+#endif
+
+/* Storage class of a variable with one copy per thread */
+#ifdef _MSC_VER
+#define THREAD_LOCAL __declspec(thread)
+#else
+#define THREAD_LOCAL __thread
+#endif
+
+/* Function run by a thread */
+typedef void (*ThreadFunction)(void* arg);
+
+/* Thread handle */
+typedef struct {
+#ifdef _WIN32
+    HANDLE handle;
+#else
+    pthread_t handle;
+#endif
+    ThreadFunction function;
+    void* arg;
+} Thread;
+
+/* Function declarations */
+
+/* Starts function(arg) on a new thread, returns 1 on success */
+int createThread(Thread* thread, ThreadFunction function, void* arg);
+
+/* Waits for a thread to finish */
+void joinThread(Thread* thread);
+
+#endif /* THREADS_H */
@@ -0,0 +1,14 @@
+/*
+ * timer.h - Wall-clock timer header
+ * Monotonic time source used for search budgets and benchmarks
+ */
+
+#ifndef TIMER_H
+#define TIMER_H
+
+/* Function declarations */
+
+/* Returns a monotonic time stamp in microseconds */
+long long getTimeMicros(void);
+
+#endif /* TIMER_H */
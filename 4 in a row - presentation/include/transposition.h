@@ -0,0 +1,67 @@
+/*
+ * transposition.h - Transposition table header
+ * Remembers search results of positions already seen (keyed by hash)
+ *
+ * The table is shared by all search threads without locks. Each slot
+ * stores the packed data word and (key XOR data). A reader only accepts
+ * a slot if XOR-ing the two words gives back its key, so a slot torn by
+ * two threads writing at once is simply treated as a miss.
+ */
+
+#ifndef TRANSPOSITION_H
+#define TRANSPOSITION_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* Default table size in megabytes */
+#define TT_DEFAULT_SIZE_MB 16
+
+/* Bound types of a stored score */
+#define TT_EXACT 0   /* Score is exact */
+#define TT_LOWER 1   /* Search failed high, real score >= stored score */
+#define TT_UPPER 2   /* Search failed low, real score <= stored score */
+
+/* Unpacked table entry */
+typedef struct {
+    int score;           /* Score from the side to move's point of view */
+    int depth;           /* Remaining depth the score was searched to */
+    int flag;            /* TT_EXACT, TT_LOWER or TT_UPPER */
+    int bestMove;        /* Best column found, -1 if none */
+} TTEntry;
+
+/* Function declarations */
+
+/* Allocates the table (size rounded down to a power of two entries).
+ * Returns 1 on success, 0 if memory could not be allocated. */
+int initTranspositionTable(size_t sizeInMB);
+
+/* Releases the table memory */
+void freeTranspositionTable(void);
+
+/* Empties all entries and resets the counters */
+void clearTranspositionTable(void);
+
+/* Starts a new search, older entries become preferred for replacement */
+void newSearchGeneration(void);
+
+/* Looks up a hash, returns 1 and fills entry on a hit */
+int probeTranspositionTable(uint64_t key, TTEntry* entry);
+
+/* Stores a search result */
+void storeTranspositionTable(uint64_t key, int depth, int score, int flag, int bestMove);
+
+/* Adds probe and hit counts of a finished search to the totals.
+ * Searches count in their own context so threads never share a counter. */
+void recordTranspositionStats(long long probes, long long hits);
+
+/* Returns the hit rate (hits / probes) in percent since the last reset */
+double getTranspositionHitRate(void);
+
+/* Returns the raw probe and hit counters */
+void getTranspositionStats(long long* probes, long long* hits);
+
+/* Resets the probe and hit counters */
+void resetTranspositionStats(void);
+
+#endif /* TRANSPOSITION_H */
@@ -7,8 +7,10 @@
 #define UI_H
 
 #include "board.h"
+#include "ai.h"
+#include "render.h"
 
-/* Color codes for Windows console */
+/* Color codes (Windows console numbers, the renderer sends ANSI codes) */
 #define COLOR_DEFAULT 7
 #define COLOR_RED 12
 #define COLOR_YELLOW 14
@@ -18,10 +20,10 @@
 
 /* Function declarations */
 
-/* Clears the console screen */
+/* Starts a new screen (overwrites the last one, no cls) */
 void clearScreen(void);
 
-/* Sets console text color */
+/* Sets text color of the following output */
 void setColor(int color);
 
 /* Displays the game board with colors */
@@ -39,6 +41,9 @@ int getPlayerMove(int board[ROWS][COLS], int player);
 /* Displays win message */
 void displayWinMessage(int player);
 
+/* Displays the work behind the computer's last move */
+void displaySearchInfo(int col, const SearchInfo* info);
+
 /* Displays tie message */
 void displayTieMessage(void);
 
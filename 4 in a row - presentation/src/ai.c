@@ -4,43 +4,117 @@
  */
 
 #include <stdlib.h>
+#include <string.h>
 #include <time.h>
 #include "../include/ai.h"
 #include "../include/game.h"
+#include "../include/bitboard.h"
+#include "../include/lines.h"
+#include "../include/book.h"
+#include "../include/solver.h"
+#include "../include/threads.h"
+#include "../include/timer.h"
 
-/* Global variable to track if random seed was initialized */
-int g_randomInitialized = 0;
+/* Columns from the center out */
+static const int g_centerOrder[COLS] = {3, 2, 4, 1, 5, 0, 6};
 
-/* Initializes random seed (call once at start) */
+/* Search budget used by getHardMove */
+static SearchLimits g_hardLimits = {BOARD_CELLS, HARD_TIME_LIMIT_MS, 0, HARD_THREADS, NULL};
+
+/* Budget used by getMonteCarloMove */
+static MctsLimits g_monteCarloLimits = {0, MONTE_CARLO_TIME_LIMIT_MS, MONTE_CARLO_THREADS, NULL};
+
+/* Monte Carlo tree of the calling thread, kept between its moves */
+static THREAD_LOCAL MctsTree g_monteCarloTree;
+
+/* Statistics of the last move of the calling thread */
+static THREAD_LOCAL SearchInfo g_lastSearchInfo;
+
+/* Clears the statistics at the start of a move, returns the start time */
+static long long beginSearchInfo(void) {
+    memset(&g_lastSearchInfo, 0, sizeof(g_lastSearchInfo));
+    g_lastSearchInfo.expectedReply = -1;
+    return getTimeMicros();
+}
+
+/* Records the time of a finished move and passes the move through */
+static int finishSearchInfo(long long start, int move) {
+    g_lastSearchInfo.elapsedMicros = getTimeMicros() - start;
+    return move;
+}
+
+/* Random number state of the calling thread (0 = not seeded yet).
+ * Every thread has its own, so games played in parallel never share
+ * or race on one sequence. */
+static THREAD_LOCAL uint64_t g_randomState = 0;
+
+/* Seeds the random numbers of the calling thread */
+void seedRandom(unsigned long long seed) {
+    /* Mix the seed so that nearby seeds give unrelated sequences */
+    uint64_t z = (uint64_t)seed + 0x9E3779B97F4A7C15ULL;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    z = z ^ (z >> 31);
+    if (z == 0) {
+        z = 1;  /* xorshift never leaves the zero state */
+    }
+    g_randomState = z;
+}
+
+/* Initializes random seed of this thread from the clock (once) */
 void initRandomSeed(void) {
-    if (g_randomInitialized == 0) {
-        srand((unsigned int)time(NULL));
-        g_randomInitialized = 1;
+    if (g_randomState == 0) {
+        /* The state's address differs per thread */
+        seedRandom((unsigned long long)time(NULL) ^ (unsigned long long)(size_t)&g_randomState);
     }
 }
 
-/* Counts consecutive discs in one direction from a position */
-int countDiscsInDirection(int board[ROWS][COLS], int row, int col, 
-                          int rowDir, int colDir, int player) {
+/* Returns a random number from 0 to limit - 1 (xorshift64*) */
+static int randomBelow(int limit) {
+    uint64_t x = g_randomState;
+
+    x ^= x >> 12;
+    x ^= x << 25;
+    x ^= x >> 27;
+    g_randomState = x;
+    return (int)(((x * 0x2545F4914F6CDD1DULL) >> 32) % (uint64_t)limit);
+}
+
+/* Counts player discs along a generated ray, nearest first */
+static int countRun(const int* cells, const unsigned char* ray, int length, int player) {
     int count = 0;
-    int r = row + rowDir;
-    int c = col + colDir;
-    
-    while (r >= 0 && r < ROWS && c >= 0 && c < COLS && 
-           board[r][c] == player) {
+
+    while (count < length && cells[ray[count]] == player) {
         count++;
-        r += rowDir;
-        c += colDir;
     }
     return count;
 }
 
+/* Counts consecutive discs in one direction from a position */
+int countDiscsInDirection(int board[ROWS][COLS], int row, int col, 
+                          int rowDir, int colDir, int player) {
+    int index = BOARD_INDEX(row, col);
+    int slot = DIRECTION_INDEX(rowDir, colDir);
+    
+    return countRun(&board[0][0], g_boardRays[index][slot], g_boardRayLength[index][slot], player);
+}
+
 /* Calculates a score for placing disc at a position */
 int calculatePositionScore(int board[ROWS][COLS], int row, int col, int player) {
+    /* Ray slots of the four lines, one way and the other */
+    static const int slots[4][2] = {
+        {DIRECTION_INDEX(0, 1), DIRECTION_INDEX(0, -1)},     /* Horizontal */
+        {DIRECTION_INDEX(1, 0), DIRECTION_INDEX(-1, 0)},     /* Vertical */
+        {DIRECTION_INDEX(1, 1), DIRECTION_INDEX(-1, -1)},    /* Diagonal-right */
+        {DIRECTION_INDEX(1, -1), DIRECTION_INDEX(-1, 1)}     /* Diagonal-left */
+    };
+    const int* cells = &board[0][0];
+    const unsigned char (*rays)[MAX_RAY_LENGTH] = g_boardRays[BOARD_INDEX(row, col)];
+    const unsigned char* lengths = g_boardRayLength[BOARD_INDEX(row, col)];
     int score = 0;
     int opponent;
     int i;
-    int rowDir, colDir;
+    int forward, back;
     int playerCount, opponentCount;
     
     /* Determine opponent */
@@ -50,21 +124,17 @@ int calculatePositionScore(int board[ROWS][COLS], int row, int col, int player)
         opponent = PLAYER1;
     }
     
-    /* Check all 4 directions: horizontal, vertical, diagonal-right, diagonal-left */
-    /* Direction pairs: (rowDir, colDir) */
-    int directions[4][2] = {{0, 1}, {1, 0}, {1, 1}, {1, -1}};
-    
     for (i = 0; i < 4; i++) {
-        rowDir = directions[i][0];
-        colDir = directions[i][1];
+        forward = slots[i][0];
+        back = slots[i][1];
         
         /* Count player discs in both directions */
-        playerCount = countDiscsInDirection(board, row, col, rowDir, colDir, player) +
-                      countDiscsInDirection(board, row, col, -rowDir, -colDir, player);
+        playerCount = countRun(cells, rays[forward], lengths[forward], player) +
+                      countRun(cells, rays[back], lengths[back], player);
         
         /* Count opponent discs in both directions */
-        opponentCount = countDiscsInDirection(board, row, col, rowDir, colDir, opponent) +
-                        countDiscsInDirection(board, row, col, -rowDir, -colDir, opponent);
+        opponentCount = countRun(cells, rays[forward], lengths[forward], opponent) +
+                        countRun(cells, rays[back], lengths[back], opponent);
         
         /* Add score based on consecutive discs */
         if (playerCount >= 3) {
@@ -93,115 +163,6 @@ int calculatePositionScore(int board[ROWS][COLS], int row, int col, int player)
     return score;
 }
 
-/* Evaluates the board state and returns a score */
-int evaluateBoardState(int board[ROWS][COLS], int aiPlayer) {
-    int opponent;
-    int score = 0;
-    int row;
-    
-    if (aiPlayer == PLAYER1) {
-        opponent = PLAYER2;
-    } else {
-        opponent = PLAYER1;
-    }
-    
-    /* Check for wins */
-    if (checkWin(board, aiPlayer)) {
-        return 1000;
-    }
-    if (checkWin(board, opponent)) {
-        return -1000;
-    }
-    
-    /* Simple heuristic: count center column control */
-    for (row = 0; row < ROWS; row++) {
-        if (board[row][3] == aiPlayer) {
-            score = score + 3;
-        }
-        if (board[row][3] == opponent) {
-            score = score - 3;
-        }
-    }
-    
-    return score;
-}
-
-/* Minimax algorithm with alpha-beta pruning for Hard difficulty */
-int minimaxAlgorithm(int board[ROWS][COLS], int depth, int isMaximizing, 
-                     int alpha, int beta, int aiPlayer) {
-    int opponent;
-    int currentPlayer;
-    int col;
-    int tempBoard[ROWS][COLS];
-    int eval;
-    int maxEval, minEval;
-    
-    /* Determine opponent */
-    if (aiPlayer == PLAYER1) {
-        opponent = PLAYER2;
-    } else {
-        opponent = PLAYER1;
-    }
-    
-    /* Determine current player */
-    if (isMaximizing) {
-        currentPlayer = aiPlayer;
-    } else {
-        currentPlayer = opponent;
-    }
-    
-    /* Terminal conditions - check for win, loss, or max depth */
-    if (checkWin(board, aiPlayer)) {
-        return 1000 - depth;
-    }
-    if (checkWin(board, opponent)) {
-        return -1000 + depth;
-    }
-    if (isBoardFull(board) || depth >= 6) {
-        return evaluateBoardState(board, aiPlayer);
-    }
-    
-    if (isMaximizing) {
-        maxEval = -10000;
-        for (col = 0; col < COLS; col++) {
-            if (isValidMove(board, col)) {
-                copyBoard(tempBoard, board);
-                dropDisc(tempBoard, col, currentPlayer);
-                eval = minimaxAlgorithm(tempBoard, depth + 1, 0, alpha, beta, aiPlayer);
-                if (eval > maxEval) {
-                    maxEval = eval;
-                }
-                if (eval > alpha) {
-                    alpha = eval;
-                }
-                if (beta <= alpha) {
-                    break;  /* Alpha-beta pruning */
-                }
-            }
-        }
-        return maxEval;
-    } else {
-        minEval = 10000;
-        for (col = 0; col < COLS; col++) {
-            if (isValidMove(board, col)) {
-                copyBoard(tempBoard, board);
-                dropDisc(tempBoard, col, currentPlayer);
-                eval = minimaxAlgorithm(tempBoard, depth + 1, 1, alpha, beta, aiPlayer);
-                if (eval < minEval) {
-                    minEval = eval;
-                }
-                if (eval < beta) {
-                    beta = eval;
-                }
-                if (beta <= alpha) {
-                    break;  /* Alpha-beta pruning */
-                }
-            }
-        }
-        return minEval;
-    }
-}
-
 /* Returns a random valid column (Easy difficulty) */
 int getRandomMove(int board[ROWS][COLS]) {
     int validMoves[COLS];
@@ -221,115 +182,468 @@ int getRandomMove(int board[ROWS][COLS]) {
     
     /* Return random valid move */
     if (count > 0) {
-        randomIndex = rand() % count;
+        randomIndex = randomBelow(count);
         return validMoves[randomIndex];
     }
     return -1;
 }
 
-/* Medium AI: checks for wins/blocks, then picks best position */
+/* Counts consecutive discs from a cell going one way along a line
+ * (step bits per cell; the empty sentinel row stops runs at the edges) */
+static int countRunBits(Bitboard discs, Bitboard cell, int step, int up) {
+    int count = 0;
+
+    while (count < 3) {
+        cell = up ? (cell << step) : (cell >> step);
+        if ((discs & cell) == 0) {
+            break;
+        }
+        count++;
+    }
+    return count;
+}
+
+/* calculatePositionScore on bitboards: same weights, no bounds checks */
+static int scoreMoveBits(Bitboard own, Bitboard opp, Bitboard cell, int col) {
+    static const int steps[4] = {BB_HEIGHT, 1, BB_HEIGHT + 1, BB_HEIGHT - 1};
+    int score = 0;
+    int ownCount, oppCount;
+    int i;
+
+    for (i = 0; i < 4; i++) {
+        ownCount = countRunBits(own, cell, steps[i], 1) + countRunBits(own, cell, steps[i], 0);
+        oppCount = countRunBits(opp, cell, steps[i], 1) + countRunBits(opp, cell, steps[i], 0);
+
+        if (ownCount >= 3) {
+            score += 100;
+        } else if (ownCount >= 2) {
+            score += 10;
+        } else if (ownCount >= 1) {
+            score += 1;
+        }
+        if (oppCount >= 3) {
+            score += 80;
+        } else if (oppCount >= 2) {
+            score += 5;
+        }
+    }
+
+    /* Prefer center column */
+    if (col == 3) {
+        score += 3;
+    } else if (col == 2 || col == 4) {
+        score += 2;
+    }
+    return score;
+}
+
+/* Packs a board into bitboards of the player's discs and of all discs
+ * (positionFromBoard without the hash, Medium does not need it) */
+static void boardToBits(int board[ROWS][COLS], int player, Bitboard* own, Bitboard* mask) {
+    Bitboard bit;
+    int row, col;
+
+    *own = 0;
+    *mask = 0;
+    for (col = 0; col < COLS; col++) {
+        bit = (Bitboard)1 << (col * BB_HEIGHT);
+        for (row = ROWS - 1; row >= 0 && board[row][col] != EMPTY; row--) {
+            *mask |= bit;
+            if (board[row][col] == player) {
+                *own |= bit;
+            }
+            bit <<= 1;
+        }
+    }
+}
+
+/* Leftmost column with a cell in the mask, -1 if there is none */
+static int firstColumnIn(Bitboard cells) {
+    int col;
+
+    for (col = 0; col < COLS; col++) {
+        if (cells & columnMask(col)) {
+            return col;
+        }
+    }
+    return -1;
+}
+
+/* Medium AI: checks for wins/blocks, then picks best position.
+ * Wins, blocks and moves that hand over a win come from the winning
+ * cell masks of both sides, so nothing is played and undone. */
 int getMediumMove(int board[ROWS][COLS], int aiPlayer) {
-    int col, row;
-    int opponent;
-    int tempBoard[ROWS][COLS];
+    Bitboard own, opponent, mask;
+    Bitboard possible;
+    Bitboard opponentWins;
+    Bitboard candidates;
+    Bitboard cell;
+    int col;
     int bestCol = -1;
     int bestScore = -1;
     int score;
+    long long start = beginSearchInfo();
     
-    initRandomSeed();
-    
-    /* Determine opponent */
-    if (aiPlayer == PLAYER1) {
-        opponent = PLAYER2;
-    } else {
-        opponent = PLAYER1;
-    }
+    boardToBits(board, aiPlayer, &own, &mask);
+    opponent = own ^ mask;
+    possible = (mask + bottomRowMask()) & fullBoardMask();
+    opponentWins = winningCells(opponent, mask);
+    g_lastSearchInfo.nodes++;
     
     /* First: Check if AI can win */
-    for (col = 0; col < COLS; col++) {
-        if (isValidMove(board, col)) {
-            copyBoard(tempBoard, board);
-            dropDisc(tempBoard, col, aiPlayer);
-            if (checkWin(tempBoard, aiPlayer)) {
-                return col;
-            }
-        }
+    col = firstColumnIn(winningCells(own, mask) & possible);
+    if (col != -1) {
+        return finishSearchInfo(start, col);
     }
     
     /* Second: Block opponent's winning move */
-    for (col = 0; col < COLS; col++) {
-        if (isValidMove(board, col)) {
-            copyBoard(tempBoard, board);
-            dropDisc(tempBoard, col, opponent);
-            if (checkWin(tempBoard, opponent)) {
-                return col;
-            }
-        }
+    col = firstColumnIn(opponentWins & possible);
+    if (col != -1) {
+        return finishSearchInfo(start, col);
     }
     
-    /* Third: Evaluate each position and pick best */
+    /* Third: Evaluate each position and pick best, leaving out moves
+     * right below an opponent winning cell while there are others */
+    candidates = possible & ~(opponentWins >> 1);
+    if (candidates == 0) {
+        candidates = possible;
+    }
     for (col = 0; col < COLS; col++) {
-        if (isValidMove(board, col)) {
-            /* Find where disc would land */
-            for (row = ROWS - 1; row >= 0; row--) {
-                if (board[row][col] == EMPTY) {
-                    score = calculatePositionScore(board, row, col, aiPlayer);
-                    if (score > bestScore) {
-                        bestScore = score;
-                        bestCol = col;
-                    }
-                    break;
-                }
+        cell = candidates & columnMask(col);
+        if (cell) {
+            score = scoreMoveBits(own, opponent, cell, col);
+            g_lastSearchInfo.nodes++;
+            g_lastSearchInfo.leafEvaluations++;
+            if (score > bestScore) {
+                bestScore = score;
+                bestCol = col;
             }
         }
     }
     
     /* If no good move found, pick random */
     if (bestCol == -1) {
-        return getRandomMove(board);
+        bestCol = getRandomMove(board);
     }
     
-    return bestCol;
+    g_lastSearchInfo.depth = 1;
+    g_lastSearchInfo.maxDepth = 1;
+    return finishSearchInfo(start, bestCol);
 }
 
-/* Hard AI: Uses minimax with alpha-beta pruning */
+/* Sets the search budget used by the Hard AI */
+void setHardSearchLimits(const SearchLimits* limits) {
+    g_hardLimits = *limits;
+}
+
+/* Returns the search budget used by the Hard AI */
+void getHardSearchLimits(SearchLimits* limits) {
+    *limits = g_hardLimits;
+}
+
+/* Opening book, then iterative-deepening minimax within the limits */
+static int searchHardMove(int board[ROWS][COLS], int aiPlayer, const SearchLimits* limits) {
+    Position pos;
+    SearchResult result;
+    int bookMove;
+    long long start = beginSearchInfo();
+    
+    /* Convert once, the search never touches the board array */
+    positionFromBoard(&pos, board, aiPlayer);
+    
+    /* Opening book first: early positions are the most expensive to search */
+    bookMove = probeOpeningBook(&pos);
+    if (bookMove != -1) {
+        g_lastSearchInfo.fromBook = 1;
+        return finishSearchInfo(start, bookMove);
+    }
+    
+    searchPosition(&pos, limits, &result);
+    
+    g_lastSearchInfo.nodes = result.nodes;
+    g_lastSearchInfo.leafEvaluations = result.leafEvaluations;
+    g_lastSearchInfo.cutoffs = result.cutoffs;
+    g_lastSearchInfo.firstMoveCutoffs = result.firstMoveCutoffs;
+    g_lastSearchInfo.depth = result.depth;
+    g_lastSearchInfo.maxDepth = result.maxPly;
+    g_lastSearchInfo.ttProbes = result.ttProbes;
+    g_lastSearchInfo.ttHits = result.ttHits;
+    g_lastSearchInfo.expectedReply = result.pvLength > 1 ? result.pv[1] : -1;
+    return finishSearchInfo(start, result.bestMove);
+}
+
+/* Hard AI: opening book, then iterative-deepening minimax within the
+ * Hard search budget */
 int getHardMove(int board[ROWS][COLS], int aiPlayer) {
-    int col;
-    int bestCol = 3;  /* Default to center */
-    int bestScore = -10000;
-    int tempBoard[ROWS][COLS];
-    int score;
-    int i;
+    return searchHardMove(board, aiPlayer, &g_hardLimits);
+}
+
+/* Perfect AI: solves the position to the end of the game and plays a
+ * move that keeps the best result (quickest win, slowest loss) */
+int getPerfectMove(int board[ROWS][COLS], int aiPlayer) {
+    Position pos;
+    SolveResult result;
+    long long start;
     
-    /* Check columns in order: center first */
-    int columnOrder[COLS] = {3, 2, 4, 1, 5, 0, 6};
+    positionFromBoard(&pos, board, aiPlayer);
     
-    for (i = 0; i < COLS; i++) {
-        col = columnOrder[i];
-        if (isValidMove(board, col)) {
-            copyBoard(tempBoard, board);
-            dropDisc(tempBoard, col, aiPlayer);
-            score = minimaxAlgorithm(tempBoard, 0, 0, -10000, 10000, aiPlayer);
-            if (score > bestScore) {
-                bestScore = score;
-                bestCol = col;
-            }
+    /* Too early to solve within a move's time: book and Hard search */
+    if (pos.moves < PERFECT_SOLVE_FROM) {
+        return getHardMove(board, aiPlayer);
+    }
+    
+    start = beginSearchInfo();
+    solve(&pos, &result);
+    if (result.bestMove == -1) {
+        return getHardMove(board, aiPlayer);  /* Solver table not available */
+    }
+    
+    /* The solver has no depth limit: every line runs to the end */
+    g_lastSearchInfo.nodes = result.nodes;
+    g_lastSearchInfo.depth = BOARD_CELLS - pos.moves;
+    g_lastSearchInfo.maxDepth = BOARD_CELLS - pos.moves;
+    return finishSearchInfo(start, result.bestMove);
+}
+
+/* Sets the search budget used by the Monte Carlo AI */
+void setMonteCarloLimits(const MctsLimits* limits) {
+    g_monteCarloLimits = *limits;
+}
+
+/* Returns the search budget used by the Monte Carlo AI */
+void getMonteCarloLimits(MctsLimits* limits) {
+    *limits = g_monteCarloLimits;
+}
+
+/* Frees the Monte Carlo tree of the calling thread */
+void releaseMonteCarloTree(void) {
+    freeMctsTree(&g_monteCarloTree);
+}
+
+/* Monte Carlo AI: UCT search within its budget, continuing the tree of
+ * this thread's previous move when the game went on from there */
+int getMonteCarloMove(int board[ROWS][COLS], int aiPlayer) {
+    Position pos;
+    MctsResult result;
+    long long start = beginSearchInfo();
+    
+    /* The pools are allocated on first use, playouts follow seedRandom */
+    if (g_monteCarloTree.nodes == NULL) {
+        if (!initMctsTree(&g_monteCarloTree, MCTS_DEFAULT_POOL_NODES)) {
+            return finishSearchInfo(start, getMediumMove(board, aiPlayer));
         }
+        initRandomSeed();
+        seedMctsTree(&g_monteCarloTree, (unsigned long long)g_randomState);
     }
     
-    return bestCol;
+    positionFromBoard(&pos, board, aiPlayer);
+    searchMcts(&g_monteCarloTree, &pos, &g_monteCarloLimits, &result);
+    
+    g_lastSearchInfo.nodes = result.treeNodes;
+    g_lastSearchInfo.leafEvaluations = result.playouts;
+    g_lastSearchInfo.playouts = result.playouts;
+    g_lastSearchInfo.reusedNodes = result.reusedNodes;
+    g_lastSearchInfo.depth = result.maxDepth;
+    g_lastSearchInfo.maxDepth = result.maxDepth;
+    return finishSearchInfo(start, result.bestMove);
+}
+
+/* Computer reply to one human move, searched while pondering */
+typedef struct {
+    uint64_t key;            /* Position after the human move */
+    int move;                /* -1 until the search has finished */
+    long long micros;        /* Time spent on it, finished or not */
+    SearchInfo info;
+} PonderReply;
+
+/* Pondering state, owned by the thread that plays the game */
+typedef struct {
+    int board[ROWS][COLS];   /* Position the human is thinking about */
+    int difficulty;
+    int aiPlayer;
+    int order[COLS];         /* Human moves, likeliest first */
+    SearchLimits limits;     /* Hard budget with the ponder stop flag */
+    PonderReply replies[COLS];
+    volatile int stop;       /* Raised when the human has moved */
+    int running;             /* 1 while the ponder thread runs */
+    int valid;               /* 1 while the replies may be used */
+    Thread thread;
+} PonderState;
+
+static PonderState g_ponder;
+
+/* Ponder thread: searches the reply to each human move in turn with the
+ * Hard budget. The transposition table keeps what a search cut short
+ * had found, so that work is not lost either. */
+static void ponderThread(void* arg) {
+    PonderState* ponder = (PonderState*)arg;
+    PonderReply* reply;
+    Position pos;
+    int after[ROWS][COLS];
+    int human = (ponder->aiPlayer == PLAYER1) ? PLAYER2 : PLAYER1;
+    int move;
+    int row;
+    int col;
+    int i;
+    long long start;
+
+    for (i = 0; i < COLS && !ponder->stop; i++) {
+        col = ponder->order[i];
+        if (!isValidMove(ponder->board, col)) {
+            continue;
+        }
+        memcpy(after, ponder->board, sizeof(after));
+        row = dropDisc(after, col, human);
+        if (getGameStateAfterMove(after, row, col, human) != GAME_ONGOING) {
+            continue;  /* Nothing to answer */
+        }
+        positionFromBoard(&pos, after, ponder->aiPlayer);
+        if (ponder->difficulty == PERFECT && pos.moves >= PERFECT_SOLVE_FROM) {
+            continue;  /* The solver can not be stopped early */
+        }
+
+        reply = &ponder->replies[col];
+        reply->key = positionKey(&pos);
+        start = getTimeMicros();
+        move = searchHardMove(after, ponder->aiPlayer, &ponder->limits);
+        reply->micros = getTimeMicros() - start;
+        if (ponder->stop) {
+            break;  /* Cut short: not the move a full search would pick */
+        }
+        reply->move = move;
+        getLastSearchInfo(&reply->info);
+    }
+}
+
+/* Starts searching the replies to every human move in the background */
+void startPondering(int board[ROWS][COLS], int difficulty, int aiPlayer) {
+    int expected = g_lastSearchInfo.expectedReply;
+    int count = 0;
+    int i;
+
+    stopPondering();
+    g_ponder.valid = 0;
+    if (difficulty != HARD && difficulty != PERFECT) {
+        return;
+    }
+
+    memcpy(g_ponder.board, board, sizeof(g_ponder.board));
+    g_ponder.difficulty = difficulty;
+    g_ponder.aiPlayer = aiPlayer;
+    g_ponder.limits = g_hardLimits;
+    g_ponder.limits.stop = &g_ponder.stop;
+    for (i = 0; i < COLS; i++) {
+        g_ponder.replies[i].key = 0;
+        g_ponder.replies[i].move = -1;
+        g_ponder.replies[i].micros = 0;
+    }
+
+    /* The reply the last search expected first, then center first */
+    if (expected >= 0 && expected < COLS) {
+        g_ponder.order[count++] = expected;
+    }
+    for (i = 0; i < COLS; i++) {
+        if (g_centerOrder[i] != expected) {
+            g_ponder.order[count++] = g_centerOrder[i];
+        }
+    }
+
+    g_ponder.stop = 0;
+    if (createThread(&g_ponder.thread, ponderThread, &g_ponder)) {
+        g_ponder.running = 1;
+        g_ponder.valid = 1;
+    }
+}
+
+/* Stops pondering and waits for the background thread */
+void stopPondering(void) {
+    if (g_ponder.running) {
+        g_ponder.stop = 1;
+        joinThread(&g_ponder.thread);
+        g_ponder.running = 0;
+    }
+}
+
+/* Answers from the pondered replies if the position is one of them:
+ * a finished reply at once, one cut short with the rest of its budget.
+ * Returns the move, or -1 if pondering did not reach this position. */
+static int takePonderedMove(int board[ROWS][COLS], int difficulty, int aiPlayer) {
+    const PonderReply* reply = NULL;
+    SearchLimits limits;
+    Position pos;
+    uint64_t key;
+    long used;
+    long long start;
+    int move;
+    int i;
+
+    if (!g_ponder.valid || g_ponder.running || difficulty != g_ponder.difficulty ||
+        aiPlayer != g_ponder.aiPlayer) {
+        return -1;
+    }
+    g_ponder.valid = 0;  /* The replies are for this move only */
+
+    positionFromBoard(&pos, board, aiPlayer);
+    key = positionKey(&pos);
+    for (i = 0; i < COLS; i++) {
+        if (g_ponder.replies[i].micros > 0 && g_ponder.replies[i].key == key) {
+            reply = &g_ponder.replies[i];
+        }
+    }
+    if (reply == NULL) {
+        return -1;
+    }
+
+    if (reply->move != -1) {
+        start = beginSearchInfo();
+        g_lastSearchInfo = reply->info;
+        g_lastSearchInfo.pondered = 1;
+        g_lastSearchInfo.ponderedMicros = reply->micros;
+        return finishSearchInfo(start, reply->move);
+    }
+
+    /* Cut short: search again, the table already holds that part */
+    limits = g_hardLimits;
+    if (limits.timeLimitMs > 0) {
+        used = (long)(reply->micros / 1000);
+        limits.timeLimitMs = limits.timeLimitMs - used > limits.timeLimitMs / 4 ?
+                             limits.timeLimitMs - used : limits.timeLimitMs / 4;
+    }
+    move = searchHardMove(board, aiPlayer, &limits);
+    g_lastSearchInfo.ponderedMicros = reply->micros;
+    return move;
 }
 
 /* Main AI function: selects move based on difficulty level */
 int getAIMove(int board[ROWS][COLS], int difficulty, int aiPlayer) {
+    long long start;
+    int move;
+    
+    /* A reply found while the human was thinking */
+    move = takePonderedMove(board, difficulty, aiPlayer);
+    if (move != -1) {
+        return move;
+    }
+    
     switch (difficulty) {
         case EASY:
-            return getRandomMove(board);
+            start = beginSearchInfo();
+            return finishSearchInfo(start, getRandomMove(board));
         case MEDIUM:
             return getMediumMove(board, aiPlayer);
         case HARD:
             return getHardMove(board, aiPlayer);
+        case PERFECT:
+            return getPerfectMove(board, aiPlayer);
+        case MONTE_CARLO:
+            return getMonteCarloMove(board, aiPlayer);
         default:
-            return getRandomMove(board);
+            start = beginSearchInfo();
+            return finishSearchInfo(start, getRandomMove(board));
     }
 }
+
+/* Copies the statistics of the last AI move made on this thread */
+void getLastSearchInfo(SearchInfo* info) {
+    *info = g_lastSearchInfo;
+}
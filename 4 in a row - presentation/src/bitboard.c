@@ -0,0 +1,101 @@
+/*
+ * bitboard.c - Bitboard position implementation
+ * Converts between the board array and the packed position
+ */
+
+#include "../include/bitboard.h"
+
+/* Sets position to an empty board */
+void initPosition(Position* pos) {
+    int col;
+    pos->current = 0;
+    pos->mask = 0;
+    pos->hash = EMPTY_BOARD_HASH;
+    pos->moves = 0;
+    for (col = 0; col < COLS; col++) {
+        pos->height[col] = 0;
+    }
+}
+
+/* Builds a position from a board array */
+void positionFromBoard(Position* pos, int board[ROWS][COLS], int playerToMove) {
+    int row, col;
+    int height;
+    int moverIndex;
+    Bitboard bit;
+
+    initPosition(pos);
+
+    for (col = 0; col < COLS; col++) {
+        /* Array row 0 is the top, bitboard row 0 is the bottom */
+        for (row = ROWS - 1; row >= 0 && board[row][col] != EMPTY; row--) {
+            height = ROWS - 1 - row;
+            bit = (Bitboard)1 << (col * BB_HEIGHT + height);
+            pos->mask |= bit;
+            if (board[row][col] == playerToMove) {
+                pos->current |= bit;
+            }
+            pos->height[col]++;
+            pos->moves++;
+        }
+    }
+
+    /* Hash needs the move count to know which side owns 'current' */
+    moverIndex = pos->moves & 1;
+    for (col = 0; col < COLS; col++) {
+        for (height = 0; height < pos->height[col]; height++) {
+            bit = (Bitboard)1 << (col * BB_HEIGHT + height);
+            if (pos->current & bit) {
+                pos->hash ^= zobristKey(moverIndex, col * ROWS + height);
+            } else {
+                pos->hash ^= zobristKey(moverIndex ^ 1, col * ROWS + height);
+            }
+        }
+    }
+}
+
+/* Writes a position back into a board array */
+void positionToBoard(const Position* pos, int board[ROWS][COLS], int playerToMove) {
+    int row, col;
+    int opponent;
+    Bitboard bit;
+
+    if (playerToMove == PLAYER1) {
+        opponent = PLAYER2;
+    } else {
+        opponent = PLAYER1;
+    }
+
+    for (col = 0; col < COLS; col++) {
+        for (row = 0; row < ROWS; row++) {
+            bit = (Bitboard)1 << (col * BB_HEIGHT + (ROWS - 1 - row));
+            if ((pos->mask & bit) == 0) {
+                board[row][col] = EMPTY;
+            } else if (pos->current & bit) {
+                board[row][col] = playerToMove;
+            } else {
+                board[row][col] = opponent;
+            }
+        }
+    }
+}
+
+/* Mirrors a bitboard left to right by swapping column groups */
+Bitboard mirrorBitboard(Bitboard b) {
+    Bitboard columnBits = ((Bitboard)1 << BB_HEIGHT) - 1;
+    Bitboard mirrored = 0;
+    int col;
+
+    for (col = 0; col < COLS; col++) {
+        mirrored |= ((b >> (col * BB_HEIGHT)) & columnBits) << ((COLS - 1 - col) * BB_HEIGHT);
+    }
+    return mirrored;
+}
+
+/* Counts set bits (parallel bit count, no loop) */
+int countBits(Bitboard b) {
+    b = b - ((b >> 1) & 0x5555555555555555ULL);
+    b = (b & 0x3333333333333333ULL) + ((b >> 2) & 0x3333333333333333ULL);
+    b = (b + (b >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+    return (int)((b * 0x0101010101010101ULL) >> 56);
+}
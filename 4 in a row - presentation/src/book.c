@@ -0,0 +1,191 @@
+/*
+ * book.c - Opening book implementation
+ * Maps the book file read-only and binary-searches it, no parsing
+ */
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+#include <stddef.h>
+#include "../include/book.h"
+
+/* Mapped book */
+static const BookHeader* g_bookHeader = NULL;
+static const uint64_t* g_bookEntries = NULL;
+static size_t g_bookSize = 0;
+#ifdef _WIN32
+static HANDLE g_bookFile = INVALID_HANDLE_VALUE;
+static HANDLE g_bookMapping = NULL;
+#endif
+
+/* Returns the canonical key of a position */
+uint64_t canonicalBookKey(const Position* pos, int* mirrored) {
+    uint64_t key = positionKey(pos);
+    uint64_t mirrorKey = mirrorBitboard(key);
+
+    if (mirrorKey < key) {
+        *mirrored = 1;
+        return mirrorKey;
+    }
+    *mirrored = 0;
+    return key;
+}
+
+/* Checks the header of a freshly mapped file */
+static int validateBook(const void* data, size_t size) {
+    const BookHeader* header = (const BookHeader*)data;
+
+    if (size < sizeof(BookHeader)) {
+        return 0;
+    }
+    if (header->magic != BOOK_MAGIC || header->version != BOOK_VERSION) {
+        return 0;
+    }
+    return size == sizeof(BookHeader) + (size_t)header->count * sizeof(uint64_t);
+}
+
+#ifdef _WIN32
+
+/* Maps a book file into memory */
+int loadOpeningBook(const char* filename) {
+    LARGE_INTEGER size;
+    const void* view;
+
+    closeOpeningBook();
+
+    g_bookFile = CreateFileA(filename, GENERIC_READ, FILE_SHARE_READ, NULL,
+                             OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (g_bookFile == INVALID_HANDLE_VALUE) {
+        return 0;
+    }
+    if (!GetFileSizeEx(g_bookFile, &size) || size.QuadPart == 0) {
+        closeOpeningBook();
+        return 0;
+    }
+
+    g_bookMapping = CreateFileMappingA(g_bookFile, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (g_bookMapping == NULL) {
+        closeOpeningBook();
+        return 0;
+    }
+    view = MapViewOfFile(g_bookMapping, FILE_MAP_READ, 0, 0, 0);
+    if (view == NULL) {
+        closeOpeningBook();
+        return 0;
+    }
+
+    g_bookHeader = (const BookHeader*)view;
+    g_bookSize = (size_t)size.QuadPart;
+    if (!validateBook(view, g_bookSize)) {
+        closeOpeningBook();
+        return 0;
+    }
+    g_bookEntries = (const uint64_t*)(g_bookHeader + 1);
+    return 1;
+}
+
+/* Unmaps the book */
+void closeOpeningBook(void) {
+    if (g_bookHeader != NULL) {
+        UnmapViewOfFile(g_bookHeader);
+    }
+    if (g_bookMapping != NULL) {
+        CloseHandle(g_bookMapping);
+    }
+    if (g_bookFile != INVALID_HANDLE_VALUE) {
+        CloseHandle(g_bookFile);
+    }
+    g_bookHeader = NULL;
+    g_bookEntries = NULL;
+    g_bookSize = 0;
+    g_bookMapping = NULL;
+    g_bookFile = INVALID_HANDLE_VALUE;
+}
+
+#else
+
+/* Maps a book file into memory */
+int loadOpeningBook(const char* filename) {
+    struct stat info;
+    void* view;
+    int fd;
+
+    closeOpeningBook();
+
+    fd = open(filename, O_RDONLY);
+    if (fd < 0) {
+        return 0;
+    }
+    if (fstat(fd, &info) != 0 || info.st_size == 0) {
+        close(fd);
+        return 0;
+    }
+
+    view = mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);  /* The mapping stays valid after closing */
+    if (view == MAP_FAILED) {
+        return 0;
+    }
+
+    g_bookHeader = (const BookHeader*)view;
+    g_bookSize = (size_t)info.st_size;
+    if (!validateBook(view, g_bookSize)) {
+        closeOpeningBook();
+        return 0;
+    }
+    g_bookEntries = (const uint64_t*)(g_bookHeader + 1);
+    return 1;
+}
+
+/* Unmaps the book */
+void closeOpeningBook(void) {
+    if (g_bookHeader != NULL) {
+        munmap((void*)g_bookHeader, g_bookSize);
+    }
+    g_bookHeader = NULL;
+    g_bookEntries = NULL;
+    g_bookSize = 0;
+}
+
+#endif
+
+/* Returns the book move for a position (binary search), or -1 */
+int probeOpeningBook(const Position* pos) {
+    uint64_t key;
+    uint64_t entryKey;
+    size_t low, high, middle;
+    int mirrored;
+    int move;
+
+    if (g_bookEntries == NULL || pos->moves > (int)g_bookHeader->plies) {
+        return -1;
+    }
+
+    key = canonicalBookKey(pos, &mirrored);
+    low = 0;
+    high = g_bookHeader->count;
+    while (low < high) {
+        middle = low + (high - low) / 2;
+        entryKey = g_bookEntries[middle] >> 8;
+        if (entryKey < key) {
+            low = middle + 1;
+        } else if (entryKey > key) {
+            high = middle;
+        } else {
+            move = (int)(g_bookEntries[middle] & 0xFF);
+            if (mirrored) {
+                move = COLS - 1 - move;
+            }
+            if (!canPlayColumn(pos, move)) {
+                return -1;  /* Corrupt entry, let the search decide */
+            }
+            return move;
+        }
+    }
+    return -1;
+}
@@ -0,0 +1,371 @@
+/*
+ * connectk.c - Connect-K engine implementation
+ * Line tables, incremental line counters, multi-word bitboard kernels
+ * and a fixed-depth alpha-beta search for any supported board size
+ */
+
+#include <string.h>
+#include "../include/connectk.h"
+#include "../include/game.h"
+#include "../include/search.h"
+
+/* Bit of a cell in the multi-word layout */
+static void setCellBit(KBitboard* b, const ConnectKRules* rules, int col, int row) {
+    int bit = col * (rules->height + 1) + row;
+    b->w[bit / 64] |= (uint64_t)1 << (bit % 64);
+}
+
+static void clearCellBit(KBitboard* b, const ConnectKRules* rules, int col, int row) {
+    int bit = col * (rules->height + 1) + row;
+    b->w[bit / 64] &= ~((uint64_t)1 << (bit % 64));
+}
+
+/* dst = src >> shift over the words in use (shift below 64 * words) */
+static void shiftRight(KBitboard* dst, const KBitboard* src, int shift, int words) {
+    int wordShift = shift / 64;
+    int bitShift = shift % 64;
+    uint64_t low, high;
+    int i;
+
+    for (i = 0; i < words; i++) {
+        low = (i + wordShift < words) ? src->w[i + wordShift] : 0;
+        high = (i + wordShift + 1 < words) ? src->w[i + wordShift + 1] : 0;
+        if (bitShift == 0) {
+            dst->w[i] = low;
+        } else {
+            dst->w[i] = (low >> bitShift) | (high << (64 - bitShift));
+        }
+    }
+}
+
+/* Returns 1 if b has K set bits spaced by step (one direction) */
+static int hasRun(const KBitboard* b, int step, int k, int words) {
+    KBitboard run = *b;
+    KBitboard shifted;
+    uint64_t any;
+    int i, j;
+
+    /* run keeps the cells that start i + 1 discs in a row */
+    for (i = 1; i < k; i++) {
+        shiftRight(&shifted, b, i * step, words);
+        any = 0;
+        for (j = 0; j < words; j++) {
+            run.w[j] &= shifted.w[j];
+            any |= run.w[j];
+        }
+        if (any == 0) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+/* Adds a line of K cells starting at (col, row) going (colStep, rowStep) */
+static void addLine(ConnectKRules* rules, int col, int row, int colStep, int rowStep) {
+    int line = rules->lineCount;
+    int cell;
+    int i;
+
+    for (i = 0; i < rules->k; i++) {
+        cell = (col + i * colStep) * rules->height + row + i * rowStep;
+        rules->lines[line][i] = (unsigned short)cell;
+        rules->cellLines[cell][rules->cellLineCount[cell]] = (unsigned short)line;
+        rules->cellLineCount[cell]++;
+    }
+    rules->lineCount++;
+}
+
+/* Sets up rules and line tables for a size, returns 0 if unsupported */
+int initConnectKRules(ConnectKRules* rules, int width, int height, int k) {
+    int col, row;
+    int count;
+    int i;
+
+    if (width < KBOARD_MIN_SIZE || width > KBOARD_MAX_WIDTH ||
+        height < KBOARD_MIN_SIZE || height > KBOARD_MAX_HEIGHT ||
+        k < KBOARD_MIN_K || k > KBOARD_MAX_K || (k > width && k > height)) {
+        return 0;
+    }
+
+    memset(rules, 0, sizeof(*rules));
+    rules->width = width;
+    rules->height = height;
+    rules->k = k;
+    rules->cells = width * height;
+    rules->words = ((height + 1) * width + 63) / 64;
+    rules->fastPath = (width == COLS && height == ROWS && k == 4);
+
+    /* Every run of K cells: horizontal, vertical and both diagonals */
+    for (col = 0; col < width; col++) {
+        for (row = 0; row < height; row++) {
+            if (col + k <= width) {
+                addLine(rules, col, row, 1, 0);
+            }
+            if (row + k <= height) {
+                addLine(rules, col, row, 0, 1);
+            }
+            if (col + k <= width && row + k <= height) {
+                addLine(rules, col, row, 1, 1);
+            }
+            if (col + k <= width && row - k + 1 >= 0) {
+                addLine(rules, col, row, 1, -1);
+            }
+        }
+    }
+
+    /* Lines held by one player score count^3, a full line is a win */
+    for (count = 0; count < k; count++) {
+        rules->lineWeight[count] = count * count * count;
+    }
+    rules->lineWeight[k] = 0;
+
+    /* Center first, then alternating outwards */
+    for (i = 0; i < width; i++) {
+        if (i % 2 == 0) {
+            rules->order[i] = (width - 1) / 2 - i / 2;
+        } else {
+            rules->order[i] = (width - 1) / 2 + (i + 1) / 2;
+        }
+    }
+    if (width % 2 == 0) {
+        /* Even width: mirror so both middle columns come first */
+        for (i = 0; i < width; i++) {
+            rules->order[i] = width - 1 - rules->order[i];
+        }
+    }
+    return 1;
+}
+
+/* Starts a game on an empty board */
+void initConnectKGame(ConnectKGame* game, const ConnectKRules* rules) {
+    memset(game, 0, sizeof(*game));
+    game->rules = rules;
+    initPosition(&game->fast);
+}
+
+/* Returns 1 if a disc can be dropped in the column */
+int connectKCanPlay(const ConnectKGame* game, int col) {
+    return col >= 0 && col < game->rules->width && game->heights[col] < game->rules->height;
+}
+
+/* Returns 1 if dropping in the column wins for the side to move */
+int connectKIsWinningMove(const ConnectKGame* game, int col) {
+    const ConnectKRules* rules = game->rules;
+    int player = game->moves & 1;
+    int cell;
+    int line;
+    int i;
+
+    if (rules->fastPath) {
+        return isWinningMove(&game->fast, col);
+    }
+
+    /* The cell is empty, so a line with K - 1 of our discs is completed */
+    cell = col * rules->height + game->heights[col];
+    for (i = 0; i < rules->cellLineCount[cell]; i++) {
+        line = rules->cellLines[cell][i];
+        if (game->lineDiscs[player][line] == rules->k - 1) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/* Line score for the first mover from the disc counts of a line */
+static int lineScore(const ConnectKRules* rules, int first, int second) {
+    if (first > 0 && second > 0) {
+        return 0;
+    }
+    return rules->lineWeight[first] - rules->lineWeight[second];
+}
+
+/* Drops a disc for the side to move, returns GAME_ONGOING, GAME_WIN or GAME_TIE */
+int connectKPlay(ConnectKGame* game, int col) {
+    const ConnectKRules* rules = game->rules;
+    unsigned char* first = game->lineDiscs[0];
+    unsigned char* second = game->lineDiscs[1];
+    int player = game->moves & 1;
+    int row = game->heights[col];
+    int cell = col * rules->height + row;
+    int won = 0;
+    int line;
+    int i;
+
+    if (rules->fastPath) {
+        won = isWinningMove(&game->fast, col);
+        playColumn(&game->fast, col);
+    } else {
+        for (i = 0; i < rules->cellLineCount[cell]; i++) {
+            line = rules->cellLines[cell][i];
+            game->score -= lineScore(rules, first[line], second[line]);
+            game->lineDiscs[player][line]++;
+            game->score += lineScore(rules, first[line], second[line]);
+            if (game->lineDiscs[player][line] == rules->k) {
+                won = 1;
+            }
+        }
+    }
+
+    setCellBit(&game->discs[player], rules, col, row);
+    game->heights[col]++;
+    game->moves++;
+
+    if (won) {
+        return GAME_WIN;
+    }
+    if (game->moves == rules->cells) {
+        return GAME_TIE;
+    }
+    return GAME_ONGOING;
+}
+
+/* Takes back the top disc of a column (must be the last move) */
+void connectKUndo(ConnectKGame* game, int col) {
+    const ConnectKRules* rules = game->rules;
+    unsigned char* first = game->lineDiscs[0];
+    unsigned char* second = game->lineDiscs[1];
+    int player;
+    int row;
+    int cell;
+    int line;
+    int i;
+
+    game->moves--;
+    game->heights[col]--;
+    player = game->moves & 1;
+    row = game->heights[col];
+    clearCellBit(&game->discs[player], rules, col, row);
+
+    if (rules->fastPath) {
+        undoColumn(&game->fast, col);
+        return;
+    }
+
+    cell = col * rules->height + row;
+    for (i = 0; i < rules->cellLineCount[cell]; i++) {
+        line = rules->cellLines[cell][i];
+        game->score -= lineScore(rules, first[line], second[line]);
+        game->lineDiscs[player][line]--;
+        game->score += lineScore(rules, first[line], second[line]);
+    }
+}
+
+/* Returns 1 if player (0 = first mover) has K in a row anywhere */
+int connectKHasAlignment(const ConnectKGame* game, int player) {
+    const ConnectKRules* rules = game->rules;
+    const KBitboard* b = &game->discs[player];
+    int stride = rules->height + 1;
+
+    return hasRun(b, 1, rules->k, rules->words) ||            /* Vertical */
+           hasRun(b, stride, rules->k, rules->words) ||       /* Horizontal */
+           hasRun(b, stride - 1, rules->k, rules->words) ||   /* Diagonal going down-right */
+           hasRun(b, stride + 1, rules->k, rules->words);     /* Diagonal going up-right */
+}
+
+/* Heuristic score for the side to move */
+static int evaluateConnectK(const ConnectKGame* game) {
+    if (game->moves & 1) {
+        return -game->score;
+    }
+    return game->score;
+}
+
+/* Negamax with alpha-beta, immediate wins are found before playing */
+static int connectKNegamax(ConnectKGame* game, int depth, int alpha, int beta,
+                           long long* nodes) {
+    const ConnectKRules* rules = game->rules;
+    int score;
+    int col;
+    int i;
+
+    (*nodes)++;
+
+    for (i = 0; i < rules->width; i++) {
+        col = rules->order[i];
+        if (connectKCanPlay(game, col) && connectKIsWinningMove(game, col)) {
+            return KWIN_SCORE - (game->moves + 1);
+        }
+    }
+    if (game->moves >= rules->cells - 1) {
+        return 0;  /* The last disc can not win: draw */
+    }
+    if (depth == 0) {
+        return evaluateConnectK(game);
+    }
+
+    for (i = 0; i < rules->width; i++) {
+        col = rules->order[i];
+        if (!connectKCanPlay(game, col)) {
+            continue;
+        }
+        connectKPlay(game, col);
+        score = -connectKNegamax(game, depth - 1, -beta, -alpha, nodes);
+        connectKUndo(game, col);
+        if (score > alpha) {
+            alpha = score;
+        }
+        if (alpha >= beta) {
+            break;
+        }
+    }
+    return alpha;
+}
+
+/* Converts a fast-path search score to the Connect-K scale */
+static int fromFastScore(const ConnectKGame* game, int score) {
+    if (score > WIN_THRESHOLD) {
+        return KWIN_SCORE - (game->moves + WIN_SCORE - score);
+    }
+    if (score < -WIN_THRESHOLD) {
+        return -(KWIN_SCORE - (game->moves + WIN_SCORE + score));
+    }
+    return score;
+}
+
+/* Alpha-beta search to a fixed depth, returns the best column */
+int searchConnectK(ConnectKGame* game, int depth, int* score, long long* nodes) {
+    const ConnectKRules* rules = game->rules;
+    SearchLimits limits;
+    SearchResult result;
+    int alpha = -KWIN_SCORE - 1;
+    int best = -1;
+    int value;
+    int col;
+    int i;
+
+    *nodes = 0;
+    *score = 0;
+
+    /* 7x6 connect-4: the Hard AI search on single-word bitboards */
+    if (rules->fastPath) {
+        limits.maxDepth = depth;
+        limits.timeLimitMs = 0;
+        limits.nodeLimit = 0;
+        limits.threads = 1;
+        limits.stop = NULL;
+        searchPosition(&game->fast, &limits, &result);
+        *score = fromFastScore(game, result.score);
+        *nodes = result.nodes;
+        return result.bestMove;
+    }
+
+    for (i = 0; i < rules->width; i++) {
+        col = rules->order[i];
+        if (!connectKCanPlay(game, col)) {
+            continue;
+        }
+        if (connectKIsWinningMove(game, col)) {
+            *score = KWIN_SCORE - (game->moves + 1);
+            return col;
+        }
+        connectKPlay(game, col);
+        value = -connectKNegamax(game, depth - 1, -KWIN_SCORE - 1, -alpha, nodes);
+        connectKUndo(game, col);
+        if (value > alpha || best == -1) {
+            alpha = value;
+            best = col;
+        }
+    }
+    *score = alpha;
+    return best;
+}
@@ -0,0 +1,149 @@
+/*
+ * eval.c - Position evaluation implementation
+ * Window scores, incremental updates and the threat bonus
+ */
+
+#include "../include/eval.h"
+
+/* Score of a window holding only one player's discs, by disc count.
+ * Three discs are mostly scored by the threat bonus below. */
+static const int g_windowWeight[5] = {0, 1, 4, 9, 0};
+
+/* Bonus of a threat (empty cell completing four) on a row of the
+ * right parity, and on any other row */
+#define THREAT_GOOD_ROW 24
+#define THREAT_OTHER_ROW 8
+
+/* Window score for the first mover by disc counts [first][second] */
+static int g_windowValue[5][5];
+
+static int g_tablesReady = 0;
+
+/* Builds the window score table (called before the first search).
+ * The windows of each cell come from the generated line tables. */
+void initEvaluationTables(void) {
+    int first, second;
+
+    if (g_tablesReady) {
+        return;
+    }
+
+    /* A window with discs of both players can never be completed */
+    for (first = 0; first <= 4; first++) {
+        for (second = 0; second <= 4; second++) {
+            if (first > 0 && second > 0) {
+                g_windowValue[first][second] = 0;
+            } else {
+                g_windowValue[first][second] = g_windowWeight[first] - g_windowWeight[second];
+            }
+        }
+    }
+
+    g_tablesReady = 1;
+}
+
+/* Sets the counters from a position */
+void initEvaluator(Evaluator* eval, const Position* pos) {
+    Bitboard firstDiscs;
+    Bitboard bit;
+    int window;
+    int col, height;
+
+    initEvaluationTables();
+
+    for (window = 0; window < LINE_COUNT; window++) {
+        eval->lines.discs[0][window] = 0;
+        eval->lines.discs[1][window] = 0;
+    }
+    eval->score = 0;
+
+    /* 'current' belongs to the first mover when an even number was played */
+    if ((pos->moves & 1) == 0) {
+        firstDiscs = pos->current;
+    } else {
+        firstDiscs = opponentDiscs(pos);
+    }
+
+    for (col = 0; col < COLS; col++) {
+        for (height = 0; height < pos->height[col]; height++) {
+            bit = (Bitboard)1 << (col * BB_HEIGHT + height);
+            if (firstDiscs & bit) {
+                evalAddDisc(eval, 0, col * ROWS + height);
+            } else {
+                evalAddDisc(eval, 1, col * ROWS + height);
+            }
+        }
+    }
+}
+
+/* Adds a disc of player (0 = first mover) on cell col * ROWS + height */
+void evalAddDisc(Evaluator* eval, int player, int cell) {
+    unsigned char* mine = eval->lines.discs[player];
+    unsigned char* first = eval->lines.discs[0];
+    unsigned char* second = eval->lines.discs[1];
+    int window;
+    int i;
+
+    for (i = 0; i < g_cellLineCount[cell]; i++) {
+        window = g_cellLines[cell][i];
+        eval->score -= g_windowValue[first[window]][second[window]];
+        mine[window]++;
+        eval->score += g_windowValue[first[window]][second[window]];
+    }
+}
+
+/* Takes back a disc added with evalAddDisc */
+void evalRemoveDisc(Evaluator* eval, int player, int cell) {
+    unsigned char* mine = eval->lines.discs[player];
+    unsigned char* first = eval->lines.discs[0];
+    unsigned char* second = eval->lines.discs[1];
+    int window;
+    int i;
+
+    for (i = 0; i < g_cellLineCount[cell]; i++) {
+        window = g_cellLines[cell][i];
+        eval->score -= g_windowValue[first[window]][second[window]];
+        mine[window]--;
+        eval->score += g_windowValue[first[window]][second[window]];
+    }
+}
+
+/* Evaluates the position for the side to move and returns a score.
+ * Threats follow the usual zugzwang rule: the first mover profits from
+ * threats on odd rows (1, 3, 5 counted from the bottom), the second
+ * mover from threats on even rows. */
+int evaluateBoardState(const Evaluator* eval, const Position* pos) {
+    Bitboard oddRows = bottomRowMask() * 0x15;   /* Heights 0, 2 and 4 */
+    Bitboard evenRows = oddRows << 1;            /* Heights 1, 3 and 5 */
+    Bitboard firstDiscs, secondDiscs;
+    Bitboard threats;
+    int score = eval->score;
+
+    if ((pos->moves & 1) == 0) {
+        firstDiscs = pos->current;
+        secondDiscs = opponentDiscs(pos);
+    } else {
+        firstDiscs = opponentDiscs(pos);
+        secondDiscs = pos->current;
+    }
+
+    threats = winningCells(firstDiscs, pos->mask);
+    score += THREAT_GOOD_ROW * countBits(threats & oddRows);
+    score += THREAT_OTHER_ROW * countBits(threats & evenRows);
+
+    threats = winningCells(secondDiscs, pos->mask);
+    score -= THREAT_GOOD_ROW * countBits(threats & evenRows);
+    score -= THREAT_OTHER_ROW * countBits(threats & oddRows);
+
+    if (score > EVAL_LIMIT) {
+        score = EVAL_LIMIT;
+    } else if (score < -EVAL_LIMIT) {
+        score = -EVAL_LIMIT;
+    }
+
+    /* Score is for the first mover, flip it when the second is to move */
+    if (pos->moves & 1) {
+        return -score;
+    }
+    return score;
+}
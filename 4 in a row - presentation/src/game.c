@@ -1,78 +1,69 @@
 /*
  * game.c - Game logic implementation
- * Handles win detection and game state
+ * Handles win detection and game state with the winning line tables
  */
 
 #include "../include/game.h"
+#include "../include/lines.h"
 
-/* Checks for 4 in a row horizontally */
-int checkHorizontal(int board[ROWS][COLS], int player) {
-    int row, col;
-    for (row = 0; row < ROWS; row++) {
-        for (col = 0; col <= COLS - 4; col++) {
-            if (board[row][col] == player &&
-                board[row][col + 1] == player &&
-                board[row][col + 2] == player &&
-                board[row][col + 3] == player) {
-                return 1;
-            }
+/* Returns 1 if player fills one of the lines first to last - 1
+ * (line numbers from the generated tables) */
+static int checkLines(int board[ROWS][COLS], int first, int last, int player) {
+    const int* cells = &board[0][0];
+    const unsigned char* line;
+    int i;
+
+    for (i = first; i < last; i++) {
+        line = g_lineBoardIndex[i];
+        if (cells[line[0]] == player &&
+            cells[line[1]] == player &&
+            cells[line[2]] == player &&
+            cells[line[3]] == player) {
+            return 1;
         }
     }
     return 0;
 }
 
+/* Checks for 4 in a row horizontally */
+int checkHorizontal(int board[ROWS][COLS], int player) {
+    return checkLines(board, FIRST_HORIZONTAL_LINE, FIRST_VERTICAL_LINE, player);
+}
+
 /* Checks for 4 in a row vertically */
 int checkVertical(int board[ROWS][COLS], int player) {
-    int row, col;
-    for (row = 0; row <= ROWS - 4; row++) {
-        for (col = 0; col < COLS; col++) {
-            if (board[row][col] == player &&
-                board[row + 1][col] == player &&
-                board[row + 2][col] == player &&
-                board[row + 3][col] == player) {
-                return 1;
-            }
-        }
-    }
-    return 0;
+    return checkLines(board, FIRST_VERTICAL_LINE, FIRST_DIAGONAL_LINE, player);
 }
 
 /* Checks for 4 in a row diagonally (both directions) */
 int checkDiagonal(int board[ROWS][COLS], int player) {
-    int row, col;
-    
-    /* Check diagonal down-right */
-    for (row = 0; row <= ROWS - 4; row++) {
-        for (col = 0; col <= COLS - 4; col++) {
-            if (board[row][col] == player &&
-                board[row + 1][col + 1] == player &&
-                board[row + 2][col + 2] == player &&
-                board[row + 3][col + 3] == player) {
-                return 1;
-            }
-        }
-    }
-    
-    /* Check diagonal up-right */
-    for (row = 3; row < ROWS; row++) {
-        for (col = 0; col <= COLS - 4; col++) {
-            if (board[row][col] == player &&
-                board[row - 1][col + 1] == player &&
-                board[row - 2][col + 2] == player &&
-                board[row - 3][col + 3] == player) {
-                return 1;
-            }
-        }
-    }
-    
-    return 0;
+    return checkLines(board, FIRST_DIAGONAL_LINE, LINE_COUNT, player);
 }
 
 /* Returns 1 if player has won, 0 otherwise */
 int checkWin(int board[ROWS][COLS], int player) {
-    return checkHorizontal(board, player) ||
-           checkVertical(board, player) ||
-           checkDiagonal(board, player);
+    return checkLines(board, 0, LINE_COUNT, player);
+}
+
+/* Returns 1 if the disc at (row, col) completes 4 in a row for player.
+ * Only the lines through that cell are checked (at most 13). */
+int checkWinAt(int board[ROWS][COLS], int row, int col, int player) {
+    const int* cells = &board[0][0];
+    const unsigned char* lines = g_cellLines[BOARD_CELL(row, col)];
+    const unsigned char* line;
+    int count = g_cellLineCount[BOARD_CELL(row, col)];
+    int i;
+    
+    for (i = 0; i < count; i++) {
+        line = g_lineBoardIndex[lines[i]];
+        if (cells[line[0]] == player &&
+            cells[line[1]] == player &&
+            cells[line[2]] == player &&
+            cells[line[3]] == player) {
+            return 1;
+        }
+    }
+    return 0;
 }
 
 /* Returns game state: GAME_WIN, GAME_TIE, or GAME_ONGOING */
@@ -85,3 +76,14 @@ int getGameState(int board[ROWS][COLS], int lastPlayer) {
     }
     return GAME_ONGOING;
 }
+
+/* Returns game state after player dropped a disc at (row, col) */
+int getGameStateAfterMove(int board[ROWS][COLS], int row, int col, int player) {
+    if (checkWinAt(board, row, col, player)) {
+        return GAME_WIN;
+    }
+    if (isBoardFull(board)) {
+        return GAME_TIE;
+    }
+    return GAME_ONGOING;
+}
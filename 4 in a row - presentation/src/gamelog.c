@@ -0,0 +1,346 @@
+/*
+ * gamelog.c - Game log implementation
+ * Buffered appends with a flush per record and an fsync every
+ * GAME_LOG_SYNC_INTERVAL records
+ */
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#define _POSIX_C_SOURCE 200112L
+#include <unistd.h>
+#endif
+#include <string.h>
+#include <time.h>
+#include "../include/gamelog.h"
+#include "../include/bitboard.h"
+
+/* Largest record: header, every cell played, checksum */
+#define MAX_RECORD_SIZE (sizeof(GameRecordHeader) + ROWS * COLS + sizeof(uint32_t))
+
+/* FNV-1a checksum of a byte range (records and stats checkpoints) */
+uint32_t checksumBytes(const void* data, size_t length) {
+    const unsigned char* bytes = (const unsigned char*)data;
+    uint32_t hash = 2166136261u;
+    size_t i;
+
+    for (i = 0; i < length; i++) {
+        hash ^= bytes[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+/* Forces written data onto the disk */
+static void syncFile(FILE* file) {
+    fflush(file);
+#ifdef _WIN32
+    _commit(_fileno(file));
+#else
+    fsync(fileno(file));
+#endif
+}
+
+/* Starts a record for a new game (start time is now) */
+void beginGameRecord(GameRecord* record, int mode, int difficulty) {
+    memset(record, 0, sizeof(*record));
+    record->mode = mode;
+    record->difficulty = difficulty;
+    record->winner = EMPTY;
+    record->startTime = (long long)time(NULL);
+}
+
+/* Reads the whole records from a byte offset on, returns the offset
+ * after the last whole record (the offset itself if there are none) */
+long long readGameLog(const char* filename, long long offset,
+                      GameRecordHandler handler, void* context) {
+    unsigned char buffer[MAX_RECORD_SIZE];
+    GameRecordHeader header;
+    GameRecord record;
+    uint32_t checksum;
+    size_t body;
+    FILE* file;
+
+    file = fopen(filename, "rb");
+    if (file == NULL) {
+        return offset;
+    }
+    if (fseek(file, (long)offset, SEEK_SET) != 0) {
+        fclose(file);
+        return offset;
+    }
+
+    while (fread(&header, sizeof(header), 1, file) == 1) {
+        /* A bad length means a torn or damaged record: stop here */
+        if (header.moveCount > ROWS * COLS ||
+            header.length != sizeof(header) + header.moveCount + sizeof(uint32_t)) {
+            break;
+        }
+        body = header.moveCount + sizeof(uint32_t);
+        memcpy(buffer, &header, sizeof(header));
+        if (fread(buffer + sizeof(header), 1, body, file) != body) {
+            break;
+        }
+        memcpy(&checksum, buffer + sizeof(header) + header.moveCount, sizeof(checksum));
+        if (checksum != checksumBytes(buffer, sizeof(header) + header.moveCount)) {
+            break;
+        }
+        offset += header.length;
+
+        /* Records of a newer version are skipped, not misread */
+        if (header.version != GAME_LOG_VERSION || handler == NULL) {
+            continue;
+        }
+        record.mode = header.mode;
+        record.difficulty = header.difficulty;
+        record.winner = header.winner;
+        record.moveCount = header.moveCount;
+        record.startTime = header.startTime;
+        record.endTime = header.endTime;
+        memcpy(record.moves, buffer + sizeof(header), header.moveCount);
+        handler(&record, context);
+    }
+
+    fclose(file);
+    return offset;
+}
+
+/* Tells what follows the last whole record of a log. Only a record
+ * whose header, if there is one, is sound and whose length runs past
+ * the end of the file counts as torn: an append cut short by a crash. */
+int checkGameLogTail(const char* filename, long long end) {
+    GameRecordHeader header;
+    FILE* file = fopen(filename, "rb");
+    long long size;
+    int tail;
+
+    if (file == NULL) {
+        return LOG_TAIL_CLEAN;
+    }
+    if (fseek(file, 0, SEEK_END) != 0) {
+        fclose(file);
+        return LOG_TAIL_DAMAGED;
+    }
+    size = (long long)ftell(file);
+
+    if (size <= end) {
+        tail = LOG_TAIL_CLEAN;
+    } else if (size - end < (long long)sizeof(header)) {
+        tail = LOG_TAIL_TORN;
+    } else if (fseek(file, (long)end, SEEK_SET) != 0 || fread(&header, sizeof(header), 1, file) != 1 ||
+               header.moveCount > ROWS * COLS ||
+               header.length != sizeof(header) + header.moveCount + sizeof(uint32_t)) {
+        tail = LOG_TAIL_DAMAGED;
+    } else {
+        /* A whole record that failed its checksum is damage, not a tear */
+        tail = end + header.length > size ? LOG_TAIL_TORN : LOG_TAIL_DAMAGED;
+    }
+    fclose(file);
+    return tail;
+}
+
+/* Opens a log for appending at end (offset returned by readGameLog) and
+ * cuts off a torn last record, returns 1 on success */
+int openGameLog(GameLog* log, const char* filename, long long end) {
+    FILE* file;
+    int tail;
+    int cut = 0;
+
+    log->file = NULL;
+    log->unsynced = 0;
+
+    /* Drop a torn record so new records do not follow garbage, but
+     * never cut off anything that may still hold whole records */
+    tail = checkGameLogTail(filename, end);
+    if (tail == LOG_TAIL_DAMAGED) {
+        return 0;
+    }
+    if (tail == LOG_TAIL_TORN) {
+        file = fopen(filename, "r+b");
+        if (file == NULL) {
+            return 0;
+        }
+#ifdef _WIN32
+        cut = _chsize(_fileno(file), (long)end) == 0;
+#else
+        cut = ftruncate(fileno(file), (off_t)end) == 0;
+#endif
+        fclose(file);
+        if (!cut) {
+            return 0;
+        }
+    }
+
+    log->file = fopen(filename, "ab");
+    if (log->file == NULL) {
+        return 0;
+    }
+    fseek(log->file, 0, SEEK_END);
+    return 1;
+}
+
+/* Appends a record (end time is now), returns 1 on success */
+int appendGameRecord(GameLog* log, GameRecord* record) {
+    unsigned char buffer[MAX_RECORD_SIZE];
+    GameRecordHeader header;
+    uint32_t checksum;
+    size_t size;
+
+    if (log->file == NULL || record->moveCount < 0 || record->moveCount > ROWS * COLS) {
+        return 0;
+    }
+    record->endTime = (long long)time(NULL);
+
+    memset(&header, 0, sizeof(header));
+    header.length = (uint16_t)(sizeof(header) + record->moveCount + sizeof(uint32_t));
+    header.version = GAME_LOG_VERSION;
+    header.mode = (uint8_t)record->mode;
+    header.difficulty = (uint8_t)record->difficulty;
+    header.winner = (uint8_t)record->winner;
+    header.moveCount = (uint8_t)record->moveCount;
+    header.startTime = record->startTime;
+    header.endTime = record->endTime;
+
+    memcpy(buffer, &header, sizeof(header));
+    memcpy(buffer + sizeof(header), record->moves, (size_t)record->moveCount);
+    size = sizeof(header) + (size_t)record->moveCount;
+    checksum = checksumBytes(buffer, size);
+    memcpy(buffer + size, &checksum, sizeof(checksum));
+    size += sizeof(checksum);
+
+    /* One buffered write, handed to the OS at once */
+    if (fwrite(buffer, 1, size, log->file) != size || fflush(log->file) != 0) {
+        return 0;
+    }
+    log->unsynced++;
+    if (log->unsynced >= GAME_LOG_SYNC_INTERVAL) {
+        syncFile(log->file);
+        log->unsynced = 0;
+    }
+    return 1;
+}
+
+/* Returns the log size in bytes (the offset of the next record) */
+long long getGameLogSize(const GameLog* log) {
+    if (log->file == NULL) {
+        return 0;
+    }
+    return (long long)ftell(log->file);
+}
+
+/* Forces the records written so far onto the disk */
+void syncGameLog(GameLog* log) {
+    if (log->file != NULL) {
+        syncFile(log->file);
+        log->unsynced = 0;
+    }
+}
+
+/* Syncs and closes the log */
+void closeGameLog(GameLog* log) {
+    if (log->file != NULL) {
+        syncFile(log->file);
+        fclose(log->file);
+        log->file = NULL;
+    }
+}
+
+/* Packs a record (no times) into out, returns the bytes written */
+int packGameRecord(const GameRecord* record, unsigned char* out) {
+    int size = packedRecordSize((unsigned char)record->moveCount);
+    uint32_t bits = 0;
+    int bitCount = 0;
+    int length = 2;
+    int i;
+
+    out[0] = (unsigned char)(record->moveCount | (record->winner << 6));
+    out[1] = (unsigned char)(record->mode | (record->difficulty << 2));
+
+    /* Whole bytes leave the accumulator as soon as they are full */
+    for (i = 0; i < record->moveCount; i++) {
+        bits |= (uint32_t)record->moves[i] << bitCount;
+        bitCount += 3;
+        while (bitCount >= 8) {
+            out[length++] = (unsigned char)bits;
+            bits >>= 8;
+            bitCount -= 8;
+        }
+    }
+    if (bitCount > 0) {
+        out[length++] = (unsigned char)bits;
+    }
+    return size;
+}
+
+/* Size of the packed record that starts with this byte */
+int packedRecordSize(unsigned char firstByte) {
+    return 2 + ((firstByte & 0x3F) * 3 + 7) / 8;
+}
+
+/* Unpacks a record from at most available bytes, returns the bytes
+ * used, 0 if the record is cut short or -1 if it can not be a record */
+int unpackGameRecord(const unsigned char* in, int available, GameRecord* record) {
+    uint32_t bits = 0;
+    int bitCount = 0;
+    int length = 2;
+    int size;
+    int i;
+
+    if (available < 1) {
+        return 0;
+    }
+    if ((in[0] & 0x3F) > ROWS * COLS || (in[0] >> 6) > PLAYER2) {
+        return -1;  /* More moves than cells, or no such winner */
+    }
+    size = packedRecordSize(in[0]);
+    if (size > available) {
+        return 0;
+    }
+
+    record->moveCount = in[0] & 0x3F;
+    record->winner = in[0] >> 6;
+    record->mode = in[1] & 0x03;
+    record->difficulty = in[1] >> 2;
+    record->startTime = 0;
+    record->endTime = 0;
+
+    for (i = 0; i < record->moveCount; i++) {
+        if (bitCount < 3) {
+            bits |= (uint32_t)in[length++] << bitCount;
+            bitCount += 8;
+        }
+        record->moves[i] = (unsigned char)(bits & 7);
+        bits >>= 3;
+        bitCount -= 3;
+    }
+    return size;
+}
+
+/* Plays a record's moves on a bitboard, returns the result they lead to
+ * (PLAYER1, PLAYER2, EMPTY for a full board) or -1 if a move is illegal,
+ * comes after a win or the game is not finished */
+int replayGameRecord(const GameRecord* record) {
+    Position pos;
+    int col;
+    int i;
+
+    initPosition(&pos);
+    for (i = 0; i < record->moveCount; i++) {
+        col = record->moves[i];
+        if (col >= COLS || !canPlayColumn(&pos, col)) {
+            return -1;
+        }
+        if (isWinningMove(&pos, col)) {
+            /* A win has to be the last move */
+            if (i != record->moveCount - 1) {
+                return -1;
+            }
+            return (i & 1) ? PLAYER2 : PLAYER1;
+        }
+        playColumn(&pos, col);
+    }
+    if (pos.moves == BOARD_CELLS) {
+        return EMPTY;
+    }
+    return -1;
+}
@@ -0,0 +1,228 @@
+/*
+ * linetables.c - Winning line tables
+ * Generated by tools/linegen.c for a 7 x 6 board, do not edit
+ */
+
+#include "../include/lines.h"
+
+/* Board indexes of each line */
+const unsigned char g_lineBoardIndex[LINE_COUNT][4] = {
+    {0, 1, 2, 3},
+    {1, 2, 3, 4},
+    {2, 3, 4, 5},
+    {3, 4, 5, 6},
+    {7, 8, 9, 10},
+    {8, 9, 10, 11},
+    {9, 10, 11, 12},
+    {10, 11, 12, 13},
+    {14, 15, 16, 17},
+    {15, 16, 17, 18},
+    {16, 17, 18, 19},
+    {17, 18, 19, 20},
+    {21, 22, 23, 24},
+    {22, 23, 24, 25},
+    {23, 24, 25, 26},
+    {24, 25, 26, 27},
+    {28, 29, 30, 31},
+    {29, 30, 31, 32},
+    {30, 31, 32, 33},
+    {31, 32, 33, 34},
+    {35, 36, 37, 38},
+    {36, 37, 38, 39},
+    {37, 38, 39, 40},
+    {38, 39, 40, 41},
+    {0, 7, 14, 21},
+    {1, 8, 15, 22},
+    {2, 9, 16, 23},
+    {3, 10, 17, 24},
+    {4, 11, 18, 25},
+    {5, 12, 19, 26},
+    {6, 13, 20, 27},
+    {7, 14, 21, 28},
+    {8, 15, 22, 29},
+    {9, 16, 23, 30},
+    {10, 17, 24, 31},
+    {11, 18, 25, 32},
+    {12, 19, 26, 33},
+    {13, 20, 27, 34},
+    {14, 21, 28, 35},
+    {15, 22, 29, 36},
+    {16, 23, 30, 37},
+    {17, 24, 31, 38},
+    {18, 25, 32, 39},
+    {19, 26, 33, 40},
+    {20, 27, 34, 41},
+    {0, 8, 16, 24},
+    {1, 9, 17, 25},
+    {2, 10, 18, 26},
+    {3, 11, 19, 27},
+    {7, 15, 23, 31},
+    {8, 16, 24, 32},
+    {9, 17, 25, 33},
+    {10, 18, 26, 34},
+    {14, 22, 30, 38},
+    {15, 23, 31, 39},
+    {16, 24, 32, 40},
+    {17, 25, 33, 41},
+    {21, 15, 9, 3},
+    {22, 16, 10, 4},
+    {23, 17, 11, 5},
+    {24, 18, 12, 6},
+    {28, 22, 16, 10},
+    {29, 23, 17, 11},
+    {30, 24, 18, 12},
+    {31, 25, 19, 13},
+    {35, 29, 23, 17},
+    {36, 30, 24, 18},
+    {37, 31, 25, 19},
+    {38, 32, 26, 20}
+};
+
+/* Lines through each cell */
+const unsigned char g_cellLines[BOARD_CELLS][MAX_CELL_LINES] = {
+    {20, 38, 65, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {16, 31, 38, 61, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {12, 24, 31, 38, 57, 0, 0, 0, 0, 0, 0, 0, 0},
+    {8, 24, 31, 38, 53, 0, 0, 0, 0, 0, 0, 0, 0},
+    {4, 24, 31, 49, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {0, 24, 45, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {20, 21, 39, 66, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {16, 17, 32, 39, 62, 65, 0, 0, 0, 0, 0, 0, 0},
+    {12, 13, 25, 32, 39, 53, 58, 61, 0, 0, 0, 0, 0},
+    {8, 9, 25, 32, 39, 49, 54, 57, 0, 0, 0, 0, 0},
+    {4, 5, 25, 32, 45, 50, 0, 0, 0, 0, 0, 0, 0},
+    {0, 1, 25, 46, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {20, 21, 22, 40, 67, 0, 0, 0, 0, 0, 0, 0, 0},
+    {16, 17, 18, 33, 40, 53, 63, 66, 0, 0, 0, 0, 0},
+    {12, 13, 14, 26, 33, 40, 49, 54, 59, 62, 65, 0, 0},
+    {8, 9, 10, 26, 33, 40, 45, 50, 55, 58, 61, 0, 0},
+    {4, 5, 6, 26, 33, 46, 51, 57, 0, 0, 0, 0, 0},
+    {0, 1, 2, 26, 47, 0, 0, 0, 0, 0, 0, 0, 0},
+    {20, 21, 22, 23, 41, 53, 68, 0, 0, 0, 0, 0, 0},
+    {16, 17, 18, 19, 34, 41, 49, 54, 64, 67, 0, 0, 0},
+    {12, 13, 14, 15, 27, 34, 41, 45, 50, 55, 60, 63, 66},
+    {8, 9, 10, 11, 27, 34, 41, 46, 51, 56, 59, 62, 65},
+    {4, 5, 6, 7, 27, 34, 47, 52, 58, 61, 0, 0, 0},
+    {0, 1, 2, 3, 27, 48, 57, 0, 0, 0, 0, 0, 0},
+    {21, 22, 23, 42, 54, 0, 0, 0, 0, 0, 0, 0, 0},
+    {17, 18, 19, 35, 42, 50, 55, 68, 0, 0, 0, 0, 0},
+    {13, 14, 15, 28, 35, 42, 46, 51, 56, 64, 67, 0, 0},
+    {9, 10, 11, 28, 35, 42, 47, 52, 60, 63, 66, 0, 0},
+    {5, 6, 7, 28, 35, 48, 59, 62, 0, 0, 0, 0, 0},
+    {1, 2, 3, 28, 58, 0, 0, 0, 0, 0, 0, 0, 0},
+    {22, 23, 43, 55, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {18, 19, 36, 43, 51, 56, 0, 0, 0, 0, 0, 0, 0},
+    {14, 15, 29, 36, 43, 47, 52, 68, 0, 0, 0, 0, 0},
+    {10, 11, 29, 36, 43, 48, 64, 67, 0, 0, 0, 0, 0},
+    {6, 7, 29, 36, 60, 63, 0, 0, 0, 0, 0, 0, 0},
+    {2, 3, 29, 59, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {23, 44, 56, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {19, 37, 44, 52, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {15, 30, 37, 44, 48, 0, 0, 0, 0, 0, 0, 0, 0},
+    {11, 30, 37, 44, 68, 0, 0, 0, 0, 0, 0, 0, 0},
+    {7, 30, 37, 64, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {3, 30, 60, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0}
+};
+
+/* Number of lines through each cell */
+const unsigned char g_cellLineCount[BOARD_CELLS] = {
+    3, 4, 5, 5, 4, 3,
+    4, 6, 8, 8, 6, 4,
+    5, 8, 11, 11, 8, 5,
+    7, 10, 13, 13, 10, 7,
+    5, 8, 11, 11, 8, 5,
+    4, 6, 8, 8, 6, 4,
+    3, 4, 5, 5, 4, 3
+};
+
+/* Board indexes along each direction, nearest first */
+const unsigned char g_boardRays[BOARD_CELLS][DIRECTION_SLOTS][MAX_RAY_LENGTH] = {
+    {{0,0,0,0,0,0}, {0,0,0,0,0,0}, {0,0,0,0,0,0}, {0,0,0,0,0,0}, {0,0,0,0,0,0}, {1,2,3,4,5,6}, {0,0,0,0,0,0}, {7,14,21,28,35,0}, {8,16,24,32,40,0}},
+    {{0,0,0,0,0,0}, {0,0,0,0,0,0}, {0,0,0,0,0,0}, {0,0,0,0,0,0}, {0,0,0,0,0,0}, {2,3,4,5,6,0}, {7,0,0,0,0,0}, {8,15,22,29,36,0}, {9,17,25,33,41,0}},
+    {{0,0,0,0,0,0}, {0,0,0,0,0,0}, {0,0,0,0,0,0}, {1,0,0,0,0,0}, {0,0,0,0,0,0}, {3,4,5,6,0,0}, {8,14,0,0,0,0}, {9,16,23,30,37,0}, {10,18,26,34,0,0}},
+    {{0,0,0,0,0,0}, {0,0,0,0,0,0}, {0,0,0,0,0,0}, {2,1,0,0,0,0}, {0,0,0,0,0,0}, {4,5,6,0,0,0}, {9,15,21,0,0,0}, {10,17,24,31,38,0}, {11,19,27,0,0,0}},
+    {{0,0,0,0,0,0}, {0,0,0,0,0,0}, {0,0,0,0,0,0}, {3,2,1,0,0,0}, {0,0,0,0,0,0}, {5,6,0,0,0,0}, {10,16,22,28,0,0}, {11,18,25,32,39,0}, {12,20,0,0,0,0}},
+    {{0,0,0,0,0,0}, {0,0,0,0,0,0}, {0,0,0,0,0,0}, {4,3,2,1,0,0}, {0,0,0,0,0,0}, {6,0,0,0,0,0}, {11,17,23,29,35,0}, {12,19,26,33,40,0}, {13,0,0,0,0,0}},
+    {{0,0,0,0,0,0}, {0,0,0,0,0,0}, {0,0,0,0,0,0}, {5,4,3,2,1,0}, {0,0,0,0,0,0}, {0,0,0,0,0,0}, {12,18,24,30,36,0}, {13,20,27,34,41,0}, {0,0,0,0,0,0}},
+    {{0,0,0,0,0,0}, {0,0,0,0,0,0}, {1,0,0,0,0,0}, {0,0,0,0,0,0}, {0,0,0,0,0,0}, {8,9,10,11,12,13}, {0,0,0,0,0,0}, {14,21,28,35,0,0}, {15,23,31,39,0,0}},
+    {{0,0,0,0,0,0}, {1,0,0,0,0,0}, {2,0,0,0,0,0}, {7,0,0,0,0,0}, {0,0,0,0,0,0}, {9,10,11,12,13,0}, {14,0,0,0,0,0}, {15,22,29,36,0,0}, {16,24,32,40,0,0}},
+    {{1,0,0,0,0,0}, {2,0,0,0,0,0}, {3,0,0,0,0,0}, {8,7,0,0,0,0}, {0,0,0,0,0,0}, {10,11,12,13,0,0}, {15,21,0,0,0,0}, {16,23,30,37,0,0}, {17,25,33,41,0,0}},
+    {{2,0,0,0,0,0}, {3,0,0,0,0,0}, {4,0,0,0,0,0}, {9,8,7,0,0,0}, {0,0,0,0,0,0}, {11,12,13,0,0,0}, {16,22,28,0,0,0}, {17,24,31,38,0,0}, {18,26,34,0,0,0}},
+    {{3,0,0,0,0,0}, {4,0,0,0,0,0}, {5,0,0,0,0,0}, {10,9,8,7,0,0}, {0,0,0,0,0,0}, {12,13,0,0,0,0}, {17,23,29,35,0,0}, {18,25,32,39,0,0}, {19,27,0,0,0,0}},
+    {{4,0,0,0,0,0}, {5,0,0,0,0,0}, {6,0,0,0,0,0}, {11,10,9,8,7,0}, {0,0,0,0,0,0}, {13,0,0,0,0,0}, {18,24,30,36,0,0}, {19,26,33,40,0,0}, {20,0,0,0,0,0}},
+    {{5,0,0,0,0,0}, {6,0,0,0,0,0}, {0,0,0,0,0,0}, {12,11,10,9,8,7}, {0,0,0,0,0,0}, {0,0,0,0,0,0}, {19,25,31,37,0,0}, {20,27,34,41,0,0}, {0,0,0,0,0,0}},
+    {{0,0,0,0,0,0}, {7,0,0,0,0,0}, {8,2,0,0,0,0}, {0,0,0,0,0,0}, {0,0,0,0,0,0}, {15,16,17,18,19,20}, {0,0,0,0,0,0}, {21,28,35,0,0,0}, {22,30,38,0,0,0}},
+    {{7,0,0,0,0,0}, {8,1,0,0,0,0}, {9,3,0,0,0,0}, {14,0,0,0,0,0}, {0,0,0,0,0,0}, {16,17,18,19,20,0}, {21,0,0,0,0,0}, {22,29,36,0,0,0}, {23,31,39,0,0,0}},
+    {{8,0,0,0,0,0}, {9,2,0,0,0,0}, {10,4,0,0,0,0}, {15,14,0,0,0,0}, {0,0,0,0,0,0}, {17,18,19,20,0,0}, {22,28,0,0,0,0}, {23,30,37,0,0,0}, {24,32,40,0,0,0}},
+    {{9,1,0,0,0,0}, {10,3,0,0,0,0}, {11,5,0,0,0,0}, {16,15,14,0,0,0}, {0,0,0,0,0,0}, {18,19,20,0,0,0}, {23,29,35,0,0,0}, {24,31,38,0,0,0}, {25,33,41,0,0,0}},
+    {{10,2,0,0,0,0}, {11,4,0,0,0,0}, {12,6,0,0,0,0}, {17,16,15,14,0,0}, {0,0,0,0,0,0}, {19,20,0,0,0,0}, {24,30,36,0,0,0}, {25,32,39,0,0,0}, {26,34,0,0,0,0}},
+    {{11,3,0,0,0,0}, {12,5,0,0,0,0}, {13,0,0,0,0,0}, {18,17,16,15,14,0}, {0,0,0,0,0,0}, {20,0,0,0,0,0}, {25,31,37,0,0,0}, {26,33,40,0,0,0}, {27,0,0,0,0,0}},
+    {{12,4,0,0,0,0}, {13,6,0,0,0,0}, {0,0,0,0,0,0}, {19,18,17,16,15,14}, {0,0,0,0,0,0}, {0,0,0,0,0,0}, {26,32,38,0,0,0}, {27,34,41,0,0,0}, {0,0,0,0,0,0}},
+    {{0,0,0,0,0,0}, {14,7,0,0,0,0}, {15,9,3,0,0,0}, {0,0,0,0,0,0}, {0,0,0,0,0,0}, {22,23,24,25,26,27}, {0,0,0,0,0,0}, {28,35,0,0,0,0}, {29,37,0,0,0,0}},
+    {{14,0,0,0,0,0}, {15,8,1,0,0,0}, {16,10,4,0,0,0}, {21,0,0,0,0,0}, {0,0,0,0,0,0}, {23,24,25,26,27,0}, {28,0,0,0,0,0}, {29,36,0,0,0,0}, {30,38,0,0,0,0}},
+    {{15,7,0,0,0,0}, {16,9,2,0,0,0}, {17,11,5,0,0,0}, {22,21,0,0,0,0}, {0,0,0,0,0,0}, {24,25,26,27,0,0}, {29,35,0,0,0,0}, {30,37,0,0,0,0}, {31,39,0,0,0,0}},
+    {{16,8,0,0,0,0}, {17,10,3,0,0,0}, {18,12,6,0,0,0}, {23,22,21,0,0,0}, {0,0,0,0,0,0}, {25,26,27,0,0,0}, {30,36,0,0,0,0}, {31,38,0,0,0,0}, {32,40,0,0,0,0}},
+    {{17,9,1,0,0,0}, {18,11,4,0,0,0}, {19,13,0,0,0,0}, {24,23,22,21,0,0}, {0,0,0,0,0,0}, {26,27,0,0,0,0}, {31,37,0,0,0,0}, {32,39,0,0,0,0}, {33,41,0,0,0,0}},
+    {{18,10,2,0,0,0}, {19,12,5,0,0,0}, {20,0,0,0,0,0}, {25,24,23,22,21,0}, {0,0,0,0,0,0}, {27,0,0,0,0,0}, {32,38,0,0,0,0}, {33,40,0,0,0,0}, {34,0,0,0,0,0}},
+    {{19,11,3,0,0,0}, {20,13,6,0,0,0}, {0,0,0,0,0,0}, {26,25,24,23,22,21}, {0,0,0,0,0,0}, {0,0,0,0,0,0}, {33,39,0,0,0,0}, {34,41,0,0,0,0}, {0,0,0,0,0,0}},
+    {{0,0,0,0,0,0}, {21,14,7,0,0,0}, {22,16,10,4,0,0}, {0,0,0,0,0,0}, {0,0,0,0,0,0}, {29,30,31,32,33,34}, {0,0,0,0,0,0}, {35,0,0,0,0,0}, {36,0,0,0,0,0}},
+    {{21,0,0,0,0,0}, {22,15,8,1,0,0}, {23,17,11,5,0,0}, {28,0,0,0,0,0}, {0,0,0,0,0,0}, {30,31,32,33,34,0}, {35,0,0,0,0,0}, {36,0,0,0,0,0}, {37,0,0,0,0,0}},
+    {{22,14,0,0,0,0}, {23,16,9,2,0,0}, {24,18,12,6,0,0}, {29,28,0,0,0,0}, {0,0,0,0,0,0}, {31,32,33,34,0,0}, {36,0,0,0,0,0}, {37,0,0,0,0,0}, {38,0,0,0,0,0}},
+    {{23,15,7,0,0,0}, {24,17,10,3,0,0}, {25,19,13,0,0,0}, {30,29,28,0,0,0}, {0,0,0,0,0,0}, {32,33,34,0,0,0}, {37,0,0,0,0,0}, {38,0,0,0,0,0}, {39,0,0,0,0,0}},
+    {{24,16,8,0,0,0}, {25,18,11,4,0,0}, {26,20,0,0,0,0}, {31,30,29,28,0,0}, {0,0,0,0,0,0}, {33,34,0,0,0,0}, {38,0,0,0,0,0}, {39,0,0,0,0,0}, {40,0,0,0,0,0}},
+    {{25,17,9,1,0,0}, {26,19,12,5,0,0}, {27,0,0,0,0,0}, {32,31,30,29,28,0}, {0,0,0,0,0,0}, {34,0,0,0,0,0}, {39,0,0,0,0,0}, {40,0,0,0,0,0}, {41,0,0,0,0,0}},
+    {{26,18,10,2,0,0}, {27,20,13,6,0,0}, {0,0,0,0,0,0}, {33,32,31,30,29,28}, {0,0,0,0,0,0}, {0,0,0,0,0,0}, {40,0,0,0,0,0}, {41,0,0,0,0,0}, {0,0,0,0,0,0}},
+    {{0,0,0,0,0,0}, {28,21,14,7,0,0}, {29,23,17,11,5,0}, {0,0,0,0,0,0}, {0,0,0,0,0,0}, {36,37,38,39,40,41}, {0,0,0,0,0,0}, {0,0,0,0,0,0}, {0,0,0,0,0,0}},
+    {{28,0,0,0,0,0}, {29,22,15,8,1,0}, {30,24,18,12,6,0}, {35,0,0,0,0,0}, {0,0,0,0,0,0}, {37,38,39,40,41,0}, {0,0,0,0,0,0}, {0,0,0,0,0,0}, {0,0,0,0,0,0}},
+    {{29,21,0,0,0,0}, {30,23,16,9,2,0}, {31,25,19,13,0,0}, {36,35,0,0,0,0}, {0,0,0,0,0,0}, {38,39,40,41,0,0}, {0,0,0,0,0,0}, {0,0,0,0,0,0}, {0,0,0,0,0,0}},
+    {{30,22,14,0,0,0}, {31,24,17,10,3,0}, {32,26,20,0,0,0}, {37,36,35,0,0,0}, {0,0,0,0,0,0}, {39,40,41,0,0,0}, {0,0,0,0,0,0}, {0,0,0,0,0,0}, {0,0,0,0,0,0}},
+    {{31,23,15,7,0,0}, {32,25,18,11,4,0}, {33,27,0,0,0,0}, {38,37,36,35,0,0}, {0,0,0,0,0,0}, {40,41,0,0,0,0}, {0,0,0,0,0,0}, {0,0,0,0,0,0}, {0,0,0,0,0,0}},
+    {{32,24,16,8,0,0}, {33,26,19,12,5,0}, {34,0,0,0,0,0}, {39,38,37,36,35,0}, {0,0,0,0,0,0}, {41,0,0,0,0,0}, {0,0,0,0,0,0}, {0,0,0,0,0,0}, {0,0,0,0,0,0}},
+    {{33,25,17,9,1,0}, {34,27,20,13,6,0}, {0,0,0,0,0,0}, {40,39,38,37,36,35}, {0,0,0,0,0,0}, {0,0,0,0,0,0}, {0,0,0,0,0,0}, {0,0,0,0,0,0}, {0,0,0,0,0,0}}
+};
+
+/* Cells in each ray */
+const unsigned char g_boardRayLength[BOARD_CELLS][DIRECTION_SLOTS] = {
+    {0, 0, 0, 0, 0, 6, 0, 5, 5},
+    {0, 0, 0, 1, 0, 5, 1, 5, 5},
+    {0, 0, 0, 2, 0, 4, 2, 5, 4},
+    {0, 0, 0, 3, 0, 3, 3, 5, 3},
+    {0, 0, 0, 4, 0, 2, 4, 5, 2},
+    {0, 0, 0, 5, 0, 1, 5, 5, 1},
+    {0, 0, 0, 6, 0, 0, 5, 5, 0},
+    {0, 1, 1, 0, 0, 6, 0, 4, 4},
+    {1, 1, 1, 1, 0, 5, 1, 4, 4},
+    {1, 1, 1, 2, 0, 4, 2, 4, 4},
+    {1, 1, 1, 3, 0, 3, 3, 4, 3},
+    {1, 1, 1, 4, 0, 2, 4, 4, 2},
+    {1, 1, 1, 5, 0, 1, 4, 4, 1},
+    {1, 1, 0, 6, 0, 0, 4, 4, 0},
+    {0, 2, 2, 0, 0, 6, 0, 3, 3},
+    {1, 2, 2, 1, 0, 5, 1, 3, 3},
+    {2, 2, 2, 2, 0, 4, 2, 3, 3},
+    {2, 2, 2, 3, 0, 3, 3, 3, 3},
+    {2, 2, 2, 4, 0, 2, 3, 3, 2},
+    {2, 2, 1, 5, 0, 1, 3, 3, 1},
+    {2, 2, 0, 6, 0, 0, 3, 3, 0},
+    {0, 3, 3, 0, 0, 6, 0, 2, 2},
+    {1, 3, 3, 1, 0, 5, 1, 2, 2},
+    {2, 3, 3, 2, 0, 4, 2, 2, 2},
+    {3, 3, 3, 3, 0, 3, 2, 2, 2},
+    {3, 3, 2, 4, 0, 2, 2, 2, 2},
+    {3, 3, 1, 5, 0, 1, 2, 2, 1},
+    {3, 3, 0, 6, 0, 0, 2, 2, 0},
+    {0, 4, 4, 0, 0, 6, 0, 1, 1},
+    {1, 4, 4, 1, 0, 5, 1, 1, 1},
+    {2, 4, 4, 2, 0, 4, 1, 1, 1},
+    {3, 4, 3, 3, 0, 3, 1, 1, 1},
+    {4, 4, 2, 4, 0, 2, 1, 1, 1},
+    {4, 4, 1, 5, 0, 1, 1, 1, 1},
+    {4, 4, 0, 6, 0, 0, 1, 1, 0},
+    {0, 5, 5, 0, 0, 6, 0, 0, 0},
+    {1, 5, 5, 1, 0, 5, 0, 0, 0},
+    {2, 5, 4, 2, 0, 4, 0, 0, 0},
+    {3, 5, 3, 3, 0, 3, 0, 0, 0},
+    {4, 5, 2, 4, 0, 2, 0, 0, 0},
+    {5, 5, 1, 5, 0, 1, 0, 0, 0},
+    {5, 5, 0, 6, 0, 0, 0, 0, 0}
+};
@@ -8,22 +8,35 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include "../include/board.h"
 #include "../include/game.h"
 #include "../include/ai.h"
 #include "../include/ui.h"
 #include "../include/stats.h"
+#include "../include/book.h"
+#include "../include/protocol.h"
 
+/* Statistics checkpoint, the games themselves are in GAME_LOG_FILE */
 #define STATS_FILE "connect4_stats.dat"
 
+/* Show search statistics after computer moves (--info on the command line) */
+static int g_showSearchInfo = 0;
+
+/* Search the computer's replies while the human thinks (--no-ponder turns it off) */
+static int g_ponder = 1;
+
 /* Runs a Player vs Player game */
 void playPvP(GameStats* stats) {
     int board[ROWS][COLS];
     int currentPlayer = PLAYER1;
     int gameState = GAME_ONGOING;
     int col;
+    int row;
+    GameRecord record;
     
     initBoard(board);
+    beginGameRecord(&record, MODE_PVP, 0);
     
     /* Main game loop */
     while (gameState == GAME_ONGOING) {
@@ -33,10 +46,11 @@ void playPvP(GameStats* stats) {
         
         /* Get player move */
         col = getPlayerMove(board, currentPlayer);
-        dropDisc(board, col, currentPlayer);
+        row = dropDisc(board, col, currentPlayer);
+        record.moves[record.moveCount++] = (unsigned char)col;
         
-        /* Check game state */
-        gameState = getGameState(board, currentPlayer);
+        /* Check game state (only lines through the new disc) */
+        gameState = getGameStateAfterMove(board, row, col, currentPlayer);
         
         /* Switch player if game continues */
         if (gameState == GAME_ONGOING) {
@@ -51,13 +65,12 @@ void playPvP(GameStats* stats) {
     
     if (gameState == GAME_WIN) {
         displayWinMessage(currentPlayer);
-        updatePvPStats(stats, currentPlayer);
+        record.winner = currentPlayer;
     } else {
         displayTieMessage();
-        updatePvPStats(stats, 0);
     }
     
-    saveStats(stats, STATS_FILE);
+    recordGame(stats, &record);
     waitForEnter();
 }
 
@@ -67,8 +80,13 @@ void playPvC(GameStats* stats, int difficulty) {
     int currentPlayer = PLAYER1;  /* Human is Player 1 */
     int gameState = GAME_ONGOING;
     int col;
+    int row;
+    int lastComputerCol = -1;
+    SearchInfo info;
+    GameRecord record;
     
     initBoard(board);
+    beginGameRecord(&record, MODE_PVC, difficulty);
     
     /* Main game loop */
     while (gameState == GAME_ONGOING) {
@@ -77,30 +95,43 @@ void playPvC(GameStats* stats, int difficulty) {
         
         /* Show difficulty level */
         setColor(COLOR_GREEN);
-        printf("  Difficulty: ");
-        if (difficulty == EASY) printf("Easy\n");
-        else if (difficulty == MEDIUM) printf("Medium\n");
-        else printf("Hard\n");
+        framePrintf("  Difficulty: ");
+        if (difficulty == EASY) framePrintf("Easy\n");
+        else if (difficulty == MEDIUM) framePrintf("Medium\n");
+        else if (difficulty == HARD) framePrintf("Hard\n");
+        else if (difficulty == MONTE_CARLO) framePrintf("Monte Carlo\n");
+        else framePrintf("Perfect\n");
         setColor(COLOR_DEFAULT);
         
         displayBoard(board);
+        if (g_showSearchInfo && lastComputerCol != -1) {
+            displaySearchInfo(lastComputerCol, &info);
+        }
         
         if (currentPlayer == PLAYER1) {
-            /* Human's turn */
+            /* Human's turn, the computer prepares its answers meanwhile */
+            if (g_ponder) {
+                startPondering(board, difficulty, PLAYER2);
+            }
             col = getPlayerMove(board, currentPlayer);
+            stopPondering();
         } else {
             /* Computer's turn */
             setColor(COLOR_YELLOW);
-            printf("  Computer is thinking...\n");
+            framePrintf("  Computer is thinking...\n");
             setColor(COLOR_DEFAULT);
+            flushFrame();
             col = getAIMove(board, difficulty, PLAYER2);
-            printf("  Computer chose column %d\n", col + 1);
+            framePrintf("  Computer chose column %d\n", col + 1);
+            getLastSearchInfo(&info);
+            lastComputerCol = col;
         }
         
-        dropDisc(board, col, currentPlayer);
+        row = dropDisc(board, col, currentPlayer);
+        record.moves[record.moveCount++] = (unsigned char)col;
         
-        /* Check game state */
-        gameState = getGameState(board, currentPlayer);
+        /* Check game state (only lines through the new disc) */
+        gameState = getGameStateAfterMove(board, row, col, currentPlayer);
         
         /* Switch player if game continues */
         if (gameState == GAME_ONGOING) {
@@ -114,23 +145,21 @@ void playPvC(GameStats* stats, int difficulty) {
     displayBoard(board);
     
     if (gameState == GAME_WIN) {
+        record.winner = currentPlayer;
         if (currentPlayer == PLAYER1) {
             setColor(COLOR_GREEN);
-            printf("\n  *** YOU WIN! ***\n\n");
+            framePrintf("\n  *** YOU WIN! ***\n\n");
             setColor(COLOR_DEFAULT);
-            updatePvCStats(stats, 1);
         } else {
             setColor(COLOR_RED);
-            printf("\n  *** COMPUTER WINS! ***\n\n");
+            framePrintf("\n  *** COMPUTER WINS! ***\n\n");
             setColor(COLOR_DEFAULT);
-            updatePvCStats(stats, 0);
         }
     } else {
         displayTieMessage();
-        updatePvCStats(stats, -1);
     }
     
-    saveStats(stats, STATS_FILE);
+    recordGame(stats, &record);
     waitForEnter();
 }
 
@@ -142,7 +171,7 @@ void handlePvCMenu(GameStats* stats) {
     while (playing) {
         clearScreen();
         displayDifficultyMenu();
-        choice = getMenuChoice(1, 4);
+        choice = getMenuChoice(1, 6);
         
         switch (choice) {
             case 1:
@@ -155,6 +184,12 @@ void handlePvCMenu(GameStats* stats) {
                 playPvC(stats, HARD);
                 break;
             case 4:
+                playPvC(stats, PERFECT);
+                break;
+            case 5:
+                playPvC(stats, MONTE_CARLO);
+                break;
+            case 6:
                 playing = 0;
                 break;
         }
@@ -162,13 +197,49 @@ void handlePvCMenu(GameStats* stats) {
 }
 
 /* Main function - program entry point */
-int main(void) {
+int main(int argc, char* argv[]) {
     GameStats stats;
     int choice;
     int running = 1;
+    int i;
+    
+    /* ANSI output (also on Windows consoles) */
+    initRenderer();
+    
+    /* Optional: --info shows search statistics of computer moves,
+     * --full-redraw rewrites the whole screen every turn,
+     * --no-ponder keeps the computer idle while the human thinks,
+     * --engine runs the text protocol on stdin/stdout instead of the menu */
+    for (i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--info") == 0) {
+            g_showSearchInfo = 1;
+        } else if (strcmp(argv[i], "--full-redraw") == 0) {
+            setRenderMode(RENDER_FULL);
+        } else if (strcmp(argv[i], "--no-ponder") == 0) {
+            g_ponder = 0;
+        } else if (strcmp(argv[i], "--engine") == 0) {
+            return runEngineProtocol(stdin, stdout);
+        }
+    }
+    
+    /* Rebuild statistics from the checkpoint and the game log */
+    if (!loadStats(&stats, STATS_FILE, GAME_LOG_FILE)) {
+        clearScreen();
+        displayTitle();
+        setColor(COLOR_RED);
+        framePrintf("\n  The game log %s is damaged.\n", GAME_LOG_FILE);
+        if (getDamagedLogFile() != NULL) {
+            framePrintf("  It was renamed to %s and a new log was started;\n", getDamagedLogFile());
+            framePrintf("  games after the damage are not in the statistics.\n\n");
+        } else {
+            framePrintf("  It could not be renamed, so games are not saved this time.\n\n");
+        }
+        setColor(COLOR_DEFAULT);
+        waitForEnter();
+    }
     
-    /* Load saved statistics */
-    loadStats(&stats, STATS_FILE);
+    /* Map the opening book if one was generated (optional) */
+    loadOpeningBook(BOOK_FILE);
     
     /* Main menu loop */
     while (running) {
@@ -195,13 +266,17 @@ int main(void) {
                 clearScreen();
                 displayTitle();
                 setColor(COLOR_GREEN);
-                printf("\n  Thank you for playing!\n");
-                printf("  Goodbye!\n\n");
+                framePrintf("\n  Thank you for playing!\n");
+                framePrintf("  Goodbye!\n\n");
                 setColor(COLOR_DEFAULT);
+                flushFrame();
                 running = 0;
                 break;
         }
     }
     
+    closeStats(&stats);
+    closeOpeningBook();
+    releaseMonteCarloTree();
     return 0;
 }
@@ -0,0 +1,551 @@
+/*
+ * mcts.c - Monte Carlo tree search implementation
+ * UCT selection, guided expansion and playouts on two bitboards
+ * (discs of the side to move and all discs), node pools with subtree
+ * reuse between moves, several threads on one tree
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "../include/mcts.h"
+#include "../include/timer.h"
+#include "../include/threads.h"
+#include "../include/atomics.h"
+
+/* Iterations between clock and stop flag checks */
+#define MCTS_CHECK_INTERVAL 64
+
+/* What the guided policy found in a position */
+#define GUIDE_NORMAL 0
+#define GUIDE_WIN 1      /* The side to move wins with the returned cell */
+#define GUIDE_LOST 2     /* The opponent has two threats, every move loses */
+
+/* Columns in the order children are created, center first */
+static const int g_columnOrder[COLS] = {3, 2, 4, 1, 5, 0, 6};
+
+/* Budget shared by the threads of one search */
+typedef struct {
+    long long playoutLimit;  /* 0 = no limit */
+    long long claimed;       /* Playouts started (only counted with a limit) */
+    long long deadline;      /* Microseconds, 0 = no limit */
+    volatile int* stop;      /* Caller's stop flag */
+    int32_t done;            /* Raised by the thread that finds the budget spent */
+} MctsBudget;
+
+/* One thread of a search */
+typedef struct {
+    MctsTree* tree;
+    MctsBudget* budget;
+    uint64_t random;         /* Playout random numbers of this thread */
+    long long playouts;
+    int maxDepth;
+    Thread thread;
+} MctsWorker;
+
+/* Allocates both pools, returns 1 on success (playouts seeded with 1) */
+int initMctsTree(MctsTree* tree, int capacity) {
+    tree->nodes = (MctsNode*)malloc((size_t)capacity * sizeof(MctsNode));
+    tree->spare = (MctsNode*)malloc((size_t)capacity * sizeof(MctsNode));
+    if (tree->nodes == NULL || tree->spare == NULL) {
+        free(tree->nodes);
+        free(tree->spare);
+        tree->nodes = NULL;
+        tree->spare = NULL;
+        tree->capacity = 0;
+        return 0;
+    }
+    tree->capacity = capacity;
+    tree->used = 0;
+    tree->hasRoot = 0;
+    seedMctsTree(tree, 1);
+    return 1;
+}
+
+/* Releases the pools */
+void freeMctsTree(MctsTree* tree) {
+    free(tree->nodes);
+    free(tree->spare);
+    tree->nodes = NULL;
+    tree->spare = NULL;
+    tree->capacity = 0;
+    tree->used = 0;
+    tree->hasRoot = 0;
+}
+
+/* Forgets the tree, the next search starts from scratch */
+void clearMctsTree(MctsTree* tree) {
+    tree->used = 0;
+    tree->hasRoot = 0;
+}
+
+/* Mixes a seed so that nearby seeds give unrelated sequences (never 0) */
+static uint64_t mixSeed(uint64_t seed) {
+    uint64_t z = seed + 0x9E3779B97F4A7C15ULL;
+
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    z = z ^ (z >> 31);
+    return z != 0 ? z : 1;
+}
+
+/* Seeds the playout random numbers */
+void seedMctsTree(MctsTree* tree, unsigned long long seed) {
+    tree->random = mixSeed((uint64_t)seed);
+}
+
+/* Returns a random number from 0 to limit - 1 (xorshift64) */
+static int randomBelow(uint64_t* random, int limit) {
+    uint64_t x = *random;
+
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    *random = x;
+    return (int)(((x >> 32) * (uint64_t)limit) >> 32);
+}
+
+/* Cells the guided policy may play for the side to move (own discs):
+ * an immediate win alone, else the cells blocking an opponent win,
+ * else every move not right below an opponent winning cell (every
+ * move if that leaves none). state tells a win or a lost position. */
+static Bitboard guidedMoves(Bitboard own, Bitboard mask, int* state) {
+    Bitboard possible = (mask + bottomRowMask()) & fullBoardMask();
+    Bitboard wins = winningCells(own, mask) & possible;
+    Bitboard opponentWins;
+    Bitboard forced;
+    Bitboard safe;
+
+    if (wins) {
+        *state = GUIDE_WIN;
+        return wins & (~wins + 1);  /* Lowest one is enough */
+    }
+    opponentWins = winningCells(own ^ mask, mask);
+    forced = possible & opponentWins;
+    if (forced) {
+        *state = (forced & (forced - 1)) ? GUIDE_LOST : GUIDE_NORMAL;
+        return forced;
+    }
+    *state = GUIDE_NORMAL;
+    safe = possible & ~(opponentWins >> 1);
+    return safe ? safe : possible;
+}
+
+/* Number of cells in a set of playable cells (at most one per column) */
+static int countCells(Bitboard cells) {
+    int count = 0;
+
+    while (cells) {
+        cells &= cells - 1;
+        count++;
+    }
+    return count;
+}
+
+/* Plays random guided moves to the end of the game. Returns the half
+ * points of the player who is not to move at the start. */
+static int playout(uint64_t* random, Bitboard own, Bitboard mask, int moves) {
+    Bitboard cells;
+    Bitboard cell;
+    int moverToPlay = 0;   /* 1 while the scored player is to move */
+    int state;
+    int pick;
+
+    while (moves < BOARD_CELLS) {
+        cells = guidedMoves(own, mask, &state);
+        if (state == GUIDE_WIN) {
+            return moverToPlay ? 2 : 0;
+        }
+        if (state == GUIDE_LOST) {
+            return moverToPlay ? 0 : 2;
+        }
+
+        /* k-th cell of the set, lowest first */
+        pick = randomBelow(random, countCells(cells));
+        while (pick-- > 0) {
+            cells &= cells - 1;
+        }
+        cell = cells & (~cells + 1);
+
+        own ^= mask;   /* The opponent's discs are the side to move now */
+        mask |= cell;
+        moves++;
+        moverToPlay ^= 1;
+    }
+    return 1;
+}
+
+/* Takes count nodes from the pool, returns the first or -1 if full */
+static int allocateNodes(MctsTree* tree, int count) {
+    int32_t used;
+
+    do {
+        used = atomicLoadAcquire(&tree->used);
+        if (used + count > tree->capacity) {
+            return -1;
+        }
+    } while (!atomicCompareExchange(&tree->used, used, used + count));
+    return used;
+}
+
+/* Creates the children of a node in one block of the pool, returns the
+ * first one or -1 if the pool is full or another thread is already
+ * expanding the node. The
+ * block is filled before firstChild links it, so a thread that sees
+ * the link also sees the children. */
+static int expandNode(MctsTree* tree, int index, Bitboard own, Bitboard mask, int moves) {
+    MctsNode* child;
+    Bitboard cells;
+    int state;
+    int count;
+    int first;
+    int col;
+    int i;
+
+    if (!atomicCompareExchange(&tree->nodes[index].firstChild, -1, MCTS_EXPANDING)) {
+        return -1;
+    }
+    cells = guidedMoves(own, mask, &state);
+    count = countCells(cells);
+    first = count > 0 ? allocateNodes(tree, count) : -1;
+    if (first < 0) {
+        atomicStoreRelease(&tree->nodes[index].firstChild, -1);
+        return -1;
+    }
+
+    child = &tree->nodes[first];
+    for (i = 0; i < COLS; i++) {
+        col = g_columnOrder[i];
+        if ((cells & columnMask(col)) == 0) {
+            continue;
+        }
+        child->visits = 0;
+        child->reward = 0;
+        child->firstChild = -1;
+        child->childCount = 0;
+        child->move = (uint8_t)col;
+        child->reserved = 0;
+        if (state == GUIDE_WIN) {
+            child->terminal = MCTS_WIN;
+        } else if (moves + 1 == BOARD_CELLS) {
+            child->terminal = MCTS_DRAW;
+        } else {
+            child->terminal = MCTS_OPEN;
+        }
+        child++;
+    }
+    tree->nodes[index].childCount = (uint8_t)count;
+    atomicStoreRelease(&tree->nodes[index].firstChild, first);
+    return first;
+}
+
+/* Child with the best UCT value (unvisited children first). Counters
+ * of other threads may change meanwhile, any recent value will do. */
+static int selectChild(MctsTree* tree, int index, int first) {
+    MctsNode* node = &tree->nodes[index];
+    MctsNode* child;
+    double logVisits = log((double)atomicLoad32(&node->visits));
+    double value;
+    double bestValue = -1.0;
+    uint32_t visits;
+    int best = first;
+    int i;
+
+    for (i = 0; i < node->childCount; i++) {
+        child = &tree->nodes[first + i];
+        visits = atomicLoad32(&child->visits);
+        if (visits == 0) {
+            return first + i;
+        }
+        value = atomicLoad32(&child->reward) / (2.0 * visits) +
+                MCTS_EXPLORATION * sqrt(logVisits / visits);
+        if (value > bestValue) {
+            bestValue = value;
+            best = first + i;
+        }
+    }
+    return best;
+}
+
+/* One iteration: selection, expansion, playout and backpropagation.
+ * Every node on the path gets its visit on the way down (the virtual
+ * loss) and its reward on the way back. Returns the depth of the node
+ * that was scored. */
+static int runIteration(MctsWorker* worker) {
+    MctsTree* tree = worker->tree;
+    int path[BOARD_CELLS + 1];
+    MctsNode* node;
+    Bitboard own = tree->rootPos.current;
+    Bitboard mask = tree->rootPos.mask;
+    int moves = tree->rootPos.moves;
+    int depth = 0;
+    int index = 0;
+    int first;
+    int result;
+    int col;
+    uint32_t seen;
+
+    path[0] = 0;
+    seen = atomicAdd32(&tree->nodes[0].visits, MCTS_VIRTUAL_LOSS);
+
+    /* Selection: down the expanded part of the tree */
+    while ((first = atomicLoadAcquire(&tree->nodes[index].firstChild)) >= 0) {
+        index = selectChild(tree, index, first);
+        seen = atomicAdd32(&tree->nodes[index].visits, MCTS_VIRTUAL_LOSS);
+        col = tree->nodes[index].move;
+        own ^= mask;
+        mask |= mask + bottomMask(col);
+        moves++;
+        path[++depth] = index;
+    }
+
+    /* Expansion of a node seen before, then the first new child */
+    node = &tree->nodes[index];
+    if (node->terminal == MCTS_OPEN && seen > 0 &&
+        (first = expandNode(tree, index, own, mask, moves)) >= 0) {
+        index = first;
+        atomicAdd32(&tree->nodes[index].visits, MCTS_VIRTUAL_LOSS);
+        col = tree->nodes[index].move;
+        own ^= mask;
+        mask |= mask + bottomMask(col);
+        moves++;
+        path[++depth] = index;
+        node = &tree->nodes[index];
+    }
+
+    /* Simulation */
+    if (node->terminal == MCTS_WIN) {
+        result = 2;
+    } else if (node->terminal == MCTS_DRAW) {
+        result = 1;
+    } else {
+        result = playout(&worker->random, own, mask, moves);
+    }
+
+    /* Backpropagation, the result flips every ply */
+    for (index = depth; index >= 0; index--) {
+        node = &tree->nodes[path[index]];
+        atomicAdd32(&node->reward, (uint32_t)result);
+        if (MCTS_VIRTUAL_LOSS > 1) {
+            atomicAdd32(&node->visits, 1u - MCTS_VIRTUAL_LOSS);
+        }
+        result = 2 - result;
+    }
+    return depth;
+}
+
+/* Runs iterations until the shared budget is spent. The first thread
+ * to find it spent raises the flag that stops the others. */
+static void runWorker(MctsWorker* worker) {
+    MctsBudget* budget = worker->budget;
+    int depth;
+
+    while (!atomicLoadAcquire(&budget->done)) {
+        if (budget->playoutLimit > 0 &&
+            atomicAdd64(&budget->claimed, 1) >= budget->playoutLimit) {
+            atomicStoreRelease(&budget->done, 1);
+            break;
+        }
+        depth = runIteration(worker);
+        worker->playouts++;
+        if (depth > worker->maxDepth) {
+            worker->maxDepth = depth;
+        }
+        if ((worker->playouts & (MCTS_CHECK_INTERVAL - 1)) == 0) {
+            if ((budget->stop != NULL && *budget->stop) ||
+                (budget->deadline > 0 && getTimeMicros() >= budget->deadline)) {
+                atomicStoreRelease(&budget->done, 1);
+            }
+        }
+    }
+}
+
+/* Helper thread: the same iterations on the shared tree */
+static void helperMctsThread(void* arg) {
+    runWorker((MctsWorker*)arg);
+}
+
+/* Finds pos at the root or one or two plies below it, returns its
+ * index or -1 */
+static int findReusableNode(const MctsTree* tree, const Position* pos) {
+    uint64_t key = positionKey(pos);
+    const MctsNode* root = &tree->nodes[0];
+    const MctsNode* child;
+    const MctsNode* grandchild;
+    Position afterChild, afterGrandchild;
+    int i, j;
+
+    if (!tree->hasRoot) {
+        return -1;
+    }
+    if (positionKey(&tree->rootPos) == key) {
+        return 0;
+    }
+    for (i = 0; i < root->childCount; i++) {
+        child = &tree->nodes[root->firstChild + i];
+        afterChild = tree->rootPos;
+        playColumn(&afterChild, child->move);
+        if (positionKey(&afterChild) == key) {
+            return root->firstChild + i;
+        }
+        for (j = 0; j < child->childCount; j++) {
+            grandchild = &tree->nodes[child->firstChild + j];
+            afterGrandchild = afterChild;
+            playColumn(&afterGrandchild, grandchild->move);
+            if (positionKey(&afterGrandchild) == key) {
+                return child->firstChild + j;
+            }
+        }
+    }
+    return -1;
+}
+
+/* Copies the subtree of a node into the spare pool as the new root and
+ * swaps the pools */
+static void keepSubtree(MctsTree* tree, int index) {
+    MctsNode* from = tree->nodes;
+    MctsNode* to = tree->spare;
+    MctsNode* node;
+    int used = 1;
+    int next;
+
+    /* Breadth-first: the copied nodes are their own queue, their
+     * firstChild still points into the old pool until they are reached */
+    to[0] = from[index];
+    for (next = 0; next < used; next++) {
+        node = &to[next];
+        if (node->firstChild < 0) {
+            continue;
+        }
+        memcpy(&to[used], &from[node->firstChild], node->childCount * sizeof(MctsNode));
+        node->firstChild = used;
+        used += node->childCount;
+    }
+
+    tree->spare = from;
+    tree->nodes = to;
+    tree->used = used;
+}
+
+/* Searches a position within the limits and returns the best move */
+int searchMcts(MctsTree* tree, const Position* pos, const MctsLimits* limits,
+               MctsResult* result) {
+    long long start = getTimeMicros();
+    MctsBudget budget;
+    MctsWorker mainWorker;
+    MctsWorker* helpers = NULL;
+    const MctsNode* root;
+    const MctsNode* child;
+    const MctsNode* best = NULL;
+    int threads;
+    int reuse;
+    int i;
+
+    memset(result, 0, sizeof(*result));
+    result->bestMove = -1;
+    if (pos->moves >= BOARD_CELLS || tree->nodes == NULL) {
+        return -1;
+    }
+    budget.playoutLimit = limits->playoutLimit > 0 ? limits->playoutLimit : 0;
+    budget.claimed = 0;
+    budget.deadline = 0;
+    budget.stop = limits->stop;
+    budget.done = 0;
+    if (limits->timeLimitMs > 0) {
+        budget.deadline = start + (long long)limits->timeLimitMs * 1000;
+    }
+    if (budget.playoutLimit == 0 && budget.deadline == 0 && budget.stop == NULL) {
+        budget.playoutLimit = MCTS_DEFAULT_PLAYOUTS;
+    }
+
+    /* Keep what the last search found about this position */
+    reuse = findReusableNode(tree, pos);
+    if (reuse > 0) {
+        keepSubtree(tree, reuse);
+    } else if (reuse < 0) {
+        tree->nodes[0].visits = 0;
+        tree->nodes[0].reward = 0;
+        tree->nodes[0].firstChild = -1;
+        tree->nodes[0].childCount = 0;
+        tree->nodes[0].move = 0;
+        tree->nodes[0].terminal = MCTS_OPEN;
+        tree->nodes[0].reserved = 0;
+        tree->used = 1;
+    }
+    tree->rootPos = *pos;
+    tree->hasRoot = 1;
+    result->reusedNodes = tree->used - 1;
+    result->reusedVisits = tree->nodes[0].visits;
+
+    if (tree->nodes[0].firstChild < 0) {
+        expandNode(tree, 0, pos->current, pos->mask, pos->moves);
+    }
+    root = &tree->nodes[0];
+
+    mainWorker.tree = tree;
+    mainWorker.budget = &budget;
+    mainWorker.random = tree->random;
+    mainWorker.playouts = 0;
+    mainWorker.maxDepth = 0;
+    result->threads = 1;
+
+    /* A single move (a win or the only block) needs no playouts */
+    if (root->childCount > 1) {
+        /* Start the helpers, each with its own playout random numbers */
+        threads = limits->threads;
+        if (threads < 1) {
+            threads = 1;
+        }
+        if (threads > MCTS_MAX_THREADS) {
+            threads = MCTS_MAX_THREADS;
+        }
+        if (threads > 1) {
+            helpers = (MctsWorker*)calloc((size_t)threads, sizeof(MctsWorker));
+            if (helpers == NULL) {
+                threads = 1;
+            }
+        }
+        for (i = 1; i < threads; i++) {
+            helpers[i] = mainWorker;
+            helpers[i].random = mixSeed(tree->random + (uint64_t)i);
+            if (!createThread(&helpers[i].thread, helperMctsThread, &helpers[i])) {
+                break;  /* Carry on with the threads we have */
+            }
+        }
+        threads = i;
+        result->threads = threads;
+
+        runWorker(&mainWorker);
+
+        result->playouts = mainWorker.playouts;
+        result->maxDepth = mainWorker.maxDepth;
+        for (i = 1; i < threads; i++) {
+            joinThread(&helpers[i].thread);
+            result->playouts += helpers[i].playouts;
+            if (helpers[i].maxDepth > result->maxDepth) {
+                result->maxDepth = helpers[i].maxDepth;
+            }
+        }
+        free(helpers);
+    }
+    tree->random = mainWorker.random;
+
+    /* The most visited move is the most trusted one */
+    for (i = 0; i < root->childCount; i++) {
+        child = &tree->nodes[root->firstChild + i];
+        if (best == NULL || child->visits > best->visits) {
+            best = child;
+        }
+    }
+    if (best != NULL) {
+        result->bestMove = best->move;
+        result->winRate = best->visits > 0 ? best->reward / (2.0 * best->visits) : 0.5;
+    }
+
+    result->elapsedMicros = getTimeMicros() - start;
+    result->playoutsPerSecond = result->elapsedMicros > 0 ?
+        (double)result->playouts * 1e6 / (double)result->elapsedMicros : 0.0;
+    result->treeNodes = tree->used;
+    result->poolFull = tree->used + COLS > tree->capacity;
+    return result->bestMove;
+}
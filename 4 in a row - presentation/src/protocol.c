@@ -0,0 +1,251 @@
+/*
+ * protocol.c - Engine text protocol implementation
+ * Command loop on the calling thread, searches on a background thread.
+ * Commands are handled in order: a command that changes the position or
+ * starts a search first waits for the running search to answer, so a
+ * whole batch can be piped in at once. Only "stop" and "quit" cut a
+ * limited search short; an infinite one is also ended by the next
+ * command that needs the engine, and by the end of input.
+ */
+
+#include <ctype.h>
+#include <errno.h>
+#include <limits.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../include/protocol.h"
+#include "../include/ai.h"
+#include "../include/search.h"
+#include "../include/transposition.h"
+#include "../include/threads.h"
+
+/* Longest command line accepted */
+#define MAX_COMMAND_LENGTH 1024
+
+/* Engine state between commands */
+typedef struct {
+    FILE* output;
+    Position position;       /* Set by the last position command */
+    Position searched;       /* Copy the running search works on */
+    SearchLimits limits;
+    volatile int stop;       /* Raised by "stop" */
+    int searching;           /* 1 while a search thread is running */
+    int infinite;            /* 1 if that search only ends when stopped */
+    Thread thread;
+} EngineState;
+
+/* Writes one answer line */
+static void reply(EngineState* state, const char* text) {
+    fprintf(state->output, "%s\n", text);
+    fflush(state->output);
+}
+
+/* Prints the result of a finished search */
+static void printSearchResult(EngineState* state, const SearchResult* result) {
+    char line[MAX_COMMAND_LENGTH];
+    int length;
+    int i;
+
+    if (result->bestMove == -1) {
+        reply(state, "bestmove none");
+        return;
+    }
+
+    length = sprintf(line, "info depth %d seldepth %d ", result->depth, result->maxPly);
+    if (result->score > WIN_THRESHOLD) {
+        length += sprintf(line + length, "score win %d", WIN_SCORE - result->score);
+    } else if (result->score < -WIN_THRESHOLD) {
+        length += sprintf(line + length, "score loss %d", WIN_SCORE + result->score);
+    } else {
+        length += sprintf(line + length, "score cp %d", result->score);
+    }
+    length += sprintf(line + length, " nodes %lld time %lld nps %lld tthits %lld/%lld pv",
+                      result->nodes, result->elapsedMicros / 1000,
+                      result->elapsedMicros > 0 ? result->nodes * 1000000 / result->elapsedMicros : 0,
+                      result->ttHits, result->ttProbes);
+    for (i = 0; i < result->pvLength; i++) {
+        length += sprintf(line + length, " %d", result->pv[i] + 1);
+    }
+    reply(state, line);
+
+    sprintf(line, "bestmove %d", result->bestMove + 1);
+    reply(state, line);
+}
+
+/* Search thread: one search, then its answer */
+static void engineSearchThread(void* arg) {
+    EngineState* state = (EngineState*)arg;
+    SearchResult result;
+
+    searchPosition(&state->searched, &state->limits, &result);
+    printSearchResult(state, &result);
+}
+
+/* Waits until the running search (if any) has answered */
+static void waitForSearch(EngineState* state) {
+    if (state->searching) {
+        joinThread(&state->thread);
+        state->searching = 0;
+    }
+}
+
+/* Ends the running search (if any) now and waits for its answer */
+static void stopSearch(EngineState* state) {
+    state->stop = 1;
+    waitForSearch(state);
+}
+
+/* Lets a limited search answer, stops an infinite one (nothing else
+ * would ever end it) */
+static void finishSearch(EngineState* state) {
+    if (state->infinite) {
+        stopSearch(state);
+    } else {
+        waitForSearch(state);
+    }
+}
+
+/* position [moves]: plays the moves on an empty board */
+static void handlePosition(EngineState* state, char* moves) {
+    Position pos;
+    char message[64];
+    int col;
+    int i;
+
+    initPosition(&pos);
+    for (i = 0; moves != NULL && moves[i] != '\0'; i++) {
+        col = moves[i] - '1';
+        if (!canPlayColumn(&pos, col)) {
+            sprintf(message, "error illegal move at %d", i + 1);
+            reply(state, message);
+            return;
+        }
+        if (isWinningMove(&pos, col)) {
+            sprintf(message, "error game is won by move %d", i + 1);
+            reply(state, message);
+            return;
+        }
+        playColumn(&pos, col);
+    }
+    state->position = pos;
+}
+
+/* Reads a whole number from 0 to max, returns 0 if text is anything else */
+static int parseCount(const char* text, long long max, long long* number) {
+    char* end;
+
+    if (!isdigit((unsigned char)text[0])) {
+        return 0;
+    }
+    errno = 0;
+    *number = strtoll(text, &end, 10);
+    return *end == '\0' && errno != ERANGE && *number <= max;
+}
+
+/* go [depth N] [movetime MS] [nodes N] [threads N] [infinite] */
+static void handleGo(EngineState* state) {
+    SearchLimits limits;
+    char* name;
+    char* value;
+    long long number;
+    int infinite = 0;
+
+    limits.maxDepth = 0;
+    limits.timeLimitMs = 0;
+    limits.nodeLimit = 0;
+    limits.threads = 1;
+    limits.stop = &state->stop;
+
+    while ((name = strtok(NULL, " \t\r\n")) != NULL) {
+        if (strcmp(name, "infinite") == 0) {
+            infinite = 1;
+            continue;
+        }
+        if (strcmp(name, "depth") != 0 && strcmp(name, "movetime") != 0 &&
+            strcmp(name, "nodes") != 0 && strcmp(name, "threads") != 0) {
+            reply(state, "error unknown go parameter");
+            return;
+        }
+        value = strtok(NULL, " \t\r\n");
+        if (value == NULL) {
+            reply(state, "error missing value");
+            return;
+        }
+        /* Every limit fits in an int except the node count */
+        if (!parseCount(value, strcmp(name, "nodes") == 0 ? LLONG_MAX : INT_MAX, &number)) {
+            reply(state, "error bad value");
+            return;
+        }
+        if (strcmp(name, "depth") == 0) {
+            limits.maxDepth = (int)number;
+        } else if (strcmp(name, "movetime") == 0) {
+            limits.timeLimitMs = (long)number;
+        } else if (strcmp(name, "nodes") == 0) {
+            limits.nodeLimit = number;
+        } else {
+            limits.threads = (int)number;
+        }
+    }
+
+    /* No limit at all: play like the Hard AI */
+    if (!infinite && limits.maxDepth == 0 && limits.timeLimitMs == 0 && limits.nodeLimit == 0) {
+        limits.timeLimitMs = HARD_TIME_LIMIT_MS;
+    }
+
+    state->searched = state->position;
+    state->limits = limits;
+    state->stop = 0;
+    if (!createThread(&state->thread, engineSearchThread, state)) {
+        reply(state, "error could not start search thread");
+        return;
+    }
+    state->searching = 1;
+    state->infinite = infinite && limits.maxDepth == 0 && limits.timeLimitMs == 0 &&
+                      limits.nodeLimit == 0;
+}
+
+/* Runs the command loop until "quit" or end of input, returns 0 */
+int runEngineProtocol(FILE* input, FILE* output) {
+    EngineState state;
+    char line[MAX_COMMAND_LENGTH];
+    char* command;
+    int running = 1;
+
+    state.output = output;
+    state.searching = 0;
+    state.infinite = 0;
+    state.stop = 0;
+    initPosition(&state.position);
+    initTranspositionTable(TT_DEFAULT_SIZE_MB);
+
+    while (running && fgets(line, sizeof(line), input) != NULL) {
+        command = strtok(line, " \t\r\n");
+        if (command == NULL) {
+            continue;  /* Empty line */
+        }
+
+        if (strcmp(command, "isready") == 0) {
+            reply(&state, "readyok");  /* Answered even while searching */
+        } else if (strcmp(command, "stop") == 0) {
+            stopSearch(&state);
+        } else if (strcmp(command, "quit") == 0) {
+            stopSearch(&state);
+            running = 0;
+        } else if (strcmp(command, "newgame") == 0) {
+            finishSearch(&state);
+            initPosition(&state.position);
+            clearTranspositionTable();
+        } else if (strcmp(command, "position") == 0) {
+            finishSearch(&state);
+            handlePosition(&state, strtok(NULL, " \t\r\n"));
+        } else if (strcmp(command, "go") == 0) {
+            finishSearch(&state);
+            handleGo(&state);
+        } else {
+            reply(&state, "error unknown command");
+        }
+    }
+
+    finishSearch(&state);  /* End of input: let the last search answer */
+    return 0;
+}
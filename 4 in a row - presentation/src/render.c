@@ -0,0 +1,410 @@
+/*
+ * render.c - Frame renderer implementation
+ * Composes frames into a character grid, compares it with the grid the
+ * terminal shows and writes the differences with write() on POSIX or
+ * WriteFile on Windows
+ */
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#define _POSIX_C_SOURCE 200112L
+#include <unistd.h>
+#include <sys/ioctl.h>
+#endif
+#include <stdio.h>
+#include <stdarg.h>
+#include <string.h>
+#include "../include/render.h"
+
+/* ANSI escape sequences */
+#define ANSI_CLEAR_SCREEN "\x1b[2J"
+#define ANSI_CLEAR_LINE "\x1b[K"      /* Rest of the line */
+#define ANSI_RESET "\x1b[0m"
+
+/* Console color number that means "default color" */
+#define DEFAULT_COLOR 7
+
+/* A cell is its character in the low byte and its color in the high
+ * byte; blanks carry no color so they match whatever color they had */
+#define CELL_BLANK ((unsigned short)' ')
+#define CELL_UNKNOWN ((unsigned short)0xFFFF)   /* Terminal content not known */
+
+/* Unchanged cells worth rewriting instead of moving the cursor past them */
+#define MAX_SKIP_GAP 4
+
+/* Frame being composed and what the terminal shows */
+static unsigned short g_next[SCREEN_MAX_ROWS][SCREEN_MAX_COLS];
+static unsigned short g_screen[SCREEN_MAX_ROWS][SCREEN_MAX_COLS];
+
+/* Rows of g_screen that may hold something other than blanks */
+static int g_screenRows = SCREEN_MAX_ROWS;
+
+/* Composing position and color */
+static int g_row = 0;
+static int g_col = 0;
+static int g_color = DEFAULT_COLOR;
+
+/* Terminal cursor and color after the bytes sent so far (-1 = unknown) */
+static int g_termRow = -1;
+static int g_termCol = -1;
+static int g_termColor = -1;
+
+/* Terminal size at the last frame (0 = unknown, e.g. not a terminal) */
+static int g_termRows = 0;
+static int g_termCols = 0;
+
+static int g_mode = RENDER_DIFF;
+static int g_needFullRedraw = 1;
+
+/* Bytes waiting to be written */
+static char g_output[FRAME_BUFFER_SIZE];
+static int g_outputLength = 0;
+
+/* Sends bytes to the terminal, retrying short writes */
+static void writeOut(const char* data, int length) {
+#ifdef _WIN32
+    HANDLE output = GetStdHandle(STD_OUTPUT_HANDLE);
+    DWORD written;
+
+    while (length > 0) {
+        if (!WriteFile(output, data, (DWORD)length, &written, NULL) || written == 0) {
+            return;
+        }
+        data += written;
+        length -= (int)written;
+    }
+#else
+    ssize_t written;
+
+    while (length > 0) {
+        written = write(STDOUT_FILENO, data, (size_t)length);
+        if (written <= 0) {
+            return;
+        }
+        data += written;
+        length -= (int)written;
+    }
+#endif
+}
+
+/* Appends raw bytes, writing the buffer out early if it is full */
+static void appendBytes(const char* data, int length) {
+    int chunk;
+
+    while (length > 0) {
+        if (g_outputLength == FRAME_BUFFER_SIZE) {
+            writeOut(g_output, g_outputLength);
+            g_outputLength = 0;
+        }
+        chunk = FRAME_BUFFER_SIZE - g_outputLength;
+        if (chunk > length) {
+            chunk = length;
+        }
+        memcpy(g_output + g_outputLength, data, (size_t)chunk);
+        g_outputLength += chunk;
+        data += chunk;
+        length -= chunk;
+    }
+}
+
+/* Appends a string */
+static void appendString(const char* text) {
+    appendBytes(text, (int)strlen(text));
+}
+
+/* Reads the terminal size, returns 0 if it is not known */
+static int readTerminalSize(int* rows, int* cols) {
+#ifdef _WIN32
+    CONSOLE_SCREEN_BUFFER_INFO info;
+
+    if (!GetConsoleScreenBufferInfo(GetStdHandle(STD_OUTPUT_HANDLE), &info)) {
+        return 0;
+    }
+    *rows = info.srWindow.Bottom - info.srWindow.Top + 1;
+    *cols = info.srWindow.Right - info.srWindow.Left + 1;
+    return 1;
+#else
+    struct winsize size;
+
+    if (ioctl(STDOUT_FILENO, TIOCGWINSZ, &size) != 0 || size.ws_row == 0) {
+        return 0;
+    }
+    *rows = size.ws_row;
+    *cols = size.ws_col;
+    return 1;
+#endif
+}
+
+/* Sets the terminal color unless it already is that color */
+static void emitColor(int color) {
+    char code[16];
+    int ansi;
+
+    if (color == g_termColor) {
+        return;
+    }
+    g_termColor = color;
+
+    if (color == DEFAULT_COLOR) {
+        appendString(ANSI_RESET);
+        return;
+    }
+
+    /* Console bits are 1 = blue, 2 = green, 4 = red, 8 = bright;
+     * ANSI colors are 1 = red, 2 = green, 4 = blue */
+    ansi = ((color & 4) ? 1 : 0) | (color & 2) | ((color & 1) ? 4 : 0);
+    sprintf(code, "\x1b[%d;%dm", (color & 8) ? 1 : 22, 30 + ansi);
+    appendString(code);
+}
+
+/* Moves the terminal cursor unless it is already there */
+static void emitMove(int row, int col) {
+    char code[32];
+
+    if (row == g_termRow && col == g_termCol) {
+        return;
+    }
+    sprintf(code, "\x1b[%d;%dH", row + 1, col + 1);
+    appendString(code);
+    g_termRow = row;
+    g_termCol = col;
+}
+
+/* Sends the changed cells of one row and erases what is left after it */
+static void emitRowChanges(int row, int width) {
+    unsigned short* next = g_next[row];
+    unsigned short* shown = g_screen[row];
+    int lastNext = -1;
+    int shownAfter = 0;
+    int runEnd;
+    int gap;
+    int col;
+    char glyph;
+
+    for (col = width - 1; col >= 0; col--) {
+        if (next[col] != CELL_BLANK) {
+            lastNext = col;
+            break;
+        }
+    }
+    for (col = lastNext + 1; col < width; col++) {
+        if (shown[col] != CELL_BLANK) {
+            shownAfter = 1;
+            break;
+        }
+    }
+
+    col = 0;
+    while (col <= lastNext) {
+        if (next[col] == shown[col]) {
+            col++;
+            continue;
+        }
+
+        /* A run of changes, short stretches of equal cells are rewritten */
+        runEnd = col;
+        gap = 0;
+        while (runEnd + 1 <= lastNext && gap <= MAX_SKIP_GAP) {
+            runEnd++;
+            if (next[runEnd] == shown[runEnd]) {
+                gap++;
+            } else {
+                gap = 0;
+            }
+        }
+        runEnd -= gap;
+
+        emitMove(row, col);
+        for (; col <= runEnd; col++) {
+            glyph = (char)(next[col] & 0xFF);
+            if (glyph != ' ') {
+                emitColor(next[col] >> 8);
+            }
+            appendBytes(&glyph, 1);
+            g_termCol++;
+        }
+    }
+
+    if (shownAfter) {
+        emitMove(row, lastNext + 1);
+        appendString(ANSI_CLEAR_LINE);
+    }
+    memcpy(shown, next, sizeof(g_screen[row]));
+}
+
+/* Empties the frame being composed */
+static void clearNextFrame(void) {
+    int row, col;
+
+    for (row = 0; row < SCREEN_MAX_ROWS; row++) {
+        for (col = 0; col < SCREEN_MAX_COLS; col++) {
+            g_next[row][col] = CELL_BLANK;
+        }
+    }
+    g_row = 0;
+    g_col = 0;
+}
+
+/* Marks the rows in use as holding unknown content */
+static void forgetScreen(void) {
+    int row, col;
+
+    for (row = 0; row < g_screenRows; row++) {
+        for (col = 0; col < SCREEN_MAX_COLS; col++) {
+            g_screen[row][col] = CELL_UNKNOWN;
+        }
+    }
+}
+
+/* Prepares the terminal, the first frame clears the whole screen */
+void initRenderer(void) {
+#ifdef _WIN32
+    /* Windows 10 consoles understand ANSI codes once this is switched on */
+    HANDLE output = GetStdHandle(STD_OUTPUT_HANDLE);
+    DWORD mode;
+
+    if (GetConsoleMode(output, &mode)) {
+        SetConsoleMode(output, mode | 0x0004);  /* ENABLE_VIRTUAL_TERMINAL_PROCESSING */
+    }
+#endif
+    readTerminalSize(&g_termRows, &g_termCols);
+    clearNextFrame();
+    g_needFullRedraw = 1;
+}
+
+/* Selects RENDER_DIFF or RENDER_FULL */
+void setRenderMode(int mode) {
+    g_mode = mode;
+}
+
+/* Starts a new frame at the top left corner of the screen */
+void beginFrame(void) {
+    int rows = 0;
+    int cols = 0;
+
+    /* A resized terminal rewraps its lines, so the copy is worthless */
+    if (readTerminalSize(&rows, &cols) && (rows != g_termRows || cols != g_termCols)) {
+        g_termRows = rows;
+        g_termCols = cols;
+        g_needFullRedraw = 1;
+    }
+
+    clearNextFrame();
+    if (g_mode == RENDER_FULL) {
+        forgetScreen();
+    }
+}
+
+/* Switches the text color (Windows console color number, 7 = default) */
+void frameColor(int color) {
+    g_color = color;
+}
+
+/* Appends formatted text to the frame */
+void framePrintf(const char* format, ...) {
+    char text[1024];
+    va_list args;
+    int i;
+
+    va_start(args, format);
+    vsnprintf(text, sizeof(text), format, args);
+    va_end(args);
+
+    for (i = 0; text[i] != '\0'; i++) {
+        if (text[i] == '\n') {
+            g_row++;
+            g_col = 0;
+            continue;
+        }
+        if (g_row < SCREEN_MAX_ROWS && g_col < SCREEN_MAX_COLS) {
+            if (text[i] == ' ') {
+                g_next[g_row][g_col] = CELL_BLANK;
+            } else {
+                g_next[g_row][g_col] = (unsigned short)((unsigned char)text[i] | (g_color << 8));
+            }
+        }
+        g_col++;
+    }
+}
+
+/* Sends the changes with one system call */
+void flushFrame(void) {
+    int width = SCREEN_MAX_COLS;
+    int rows;
+    int row, col;
+
+    if (g_needFullRedraw) {
+        g_termColor = -1;
+        emitColor(DEFAULT_COLOR);
+        appendString(ANSI_CLEAR_SCREEN);
+        for (row = 0; row < SCREEN_MAX_ROWS; row++) {
+            for (col = 0; col < SCREEN_MAX_COLS; col++) {
+                g_screen[row][col] = CELL_BLANK;
+            }
+        }
+        g_screenRows = 0;
+        g_termRow = -1;
+        g_needFullRedraw = 0;
+    }
+
+    /* Lines longer than the terminal would wrap, keep them on their row */
+    if (g_termCols > 0 && g_termCols < width) {
+        width = g_termCols;
+    }
+
+    rows = g_row + 1;
+    if (rows > SCREEN_MAX_ROWS) {
+        rows = SCREEN_MAX_ROWS;
+    }
+    if (g_screenRows > rows) {
+        rows = g_screenRows;
+    }
+    for (row = 0; row < rows; row++) {
+        emitRowChanges(row, width);
+    }
+    g_screenRows = rows > g_row + 1 ? g_row + 1 : rows;
+
+    /* Leave the cursor where the text ends, in the color it ends with */
+    emitMove(g_row < SCREEN_MAX_ROWS ? g_row : SCREEN_MAX_ROWS - 1, g_col < width ? g_col : width - 1);
+    emitColor(g_color);
+
+    /* A frame taller than the terminal scrolled it */
+    if (g_termRows > 0 && g_row >= g_termRows) {
+        g_needFullRedraw = 1;
+    }
+
+    fflush(stdout);  /* Anything still printed with printf goes first */
+    writeOut(g_output, g_outputLength);
+    g_outputLength = 0;
+}
+
+/* Tells the renderer the terminal echoed a line of input at the cursor */
+void frameInputEchoed(void) {
+    int col;
+
+    /* The typed text sits after the prompt and the Enter key moved the
+     * cursor to the next line */
+    if (g_row < SCREEN_MAX_ROWS) {
+        for (col = g_col; col < SCREEN_MAX_COLS; col++) {
+            g_screen[g_row][col] = CELL_UNKNOWN;
+        }
+    }
+    g_row++;
+    g_col = 0;
+    if (g_row < SCREEN_MAX_ROWS) {
+        for (col = 0; col < SCREEN_MAX_COLS; col++) {
+            g_screen[g_row][col] = CELL_UNKNOWN;
+        }
+    }
+    if (g_screenRows < g_row + 1) {
+        g_screenRows = g_row < SCREEN_MAX_ROWS ? g_row + 1 : SCREEN_MAX_ROWS;
+    }
+    g_termRow = g_row;
+    g_termCol = 0;
+
+    /* Echoing on the bottom line scrolled the screen */
+    if (g_termRows > 0 && g_row >= g_termRows) {
+        g_needFullRedraw = 1;
+    }
+}
@@ -0,0 +1,562 @@
+/*
+ * search.c - Alpha-beta search implementation
+ * Iterative deepening driver and minimax
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "../include/search.h"
+#include "../include/transposition.h"
+#include "../include/timer.h"
+#include "../include/threads.h"
+
+/* The clock is read once per this many nodes (must be a power of two) */
+#define TIME_CHECK_INTERVAL 1024
+
+/* Move ordering keys: table move, then killers, then history scores
+ * (history is kept below ORDER_HISTORY_MAX) */
+#define ORDER_TT_MOVE (1 << 30)
+#define ORDER_KILLER_1 (1 << 29)
+#define ORDER_KILLER_2 (1 << 28)
+#define ORDER_HISTORY_MAX (1 << 27)
+
+/* Root move order when nothing better is known: center first */
+static const int g_centerOrder[COLS] = {3, 2, 4, 1, 5, 0, 6};
+
+/* Win scores depend on the ply they were found at. The table stores
+ * them relative to the stored node so they stay valid at other plies. */
+static int scoreToTable(int score, int depth) {
+    if (score > WIN_THRESHOLD) {
+        return score + depth;
+    }
+    if (score < -WIN_THRESHOLD) {
+        return score - depth;
+    }
+    return score;
+}
+
+/* Converts a stored score back to a score at the given ply */
+static int scoreFromTable(int score, int depth) {
+    if (score > WIN_THRESHOLD) {
+        return score - depth;
+    }
+    if (score < -WIN_THRESHOLD) {
+        return score + depth;
+    }
+    return score;
+}
+
+/* Counts a node and sets ctx->stopped once a budget has run out */
+static void countNode(SearchContext* ctx) {
+    ctx->nodes++;
+    if (ctx->sharedStop != NULL && *ctx->sharedStop) {
+        ctx->stopped = 1;
+    }
+    if (ctx->nodeLimit > 0 && ctx->nodes >= ctx->nodeLimit) {
+        ctx->stopped = 1;
+    }
+    if (ctx->deadline > 0 && (ctx->nodes & (TIME_CHECK_INTERVAL - 1)) == 0 &&
+        getTimeMicros() >= ctx->deadline) {
+        ctx->stopped = 1;
+    }
+}
+
+/* Plays a move in place, pushes it on the undo stack and updates the
+ * evaluator */
+void makeMove(SearchContext* ctx, Position* pos, int col) {
+    ctx->moveStack[ctx->stackSize] = col;
+    ctx->stackSize++;
+    evalAddDisc(&ctx->eval, pos->moves & 1, col * ROWS + pos->height[col]);
+    playColumn(pos, col);
+}
+
+/* Takes back the last move on the undo stack */
+void unmakeMove(SearchContext* ctx, Position* pos) {
+    int col;
+
+    ctx->stackSize--;
+    col = ctx->moveStack[ctx->stackSize];
+    undoColumn(pos, col);
+    evalRemoveDisc(&ctx->eval, pos->moves & 1, col * ROWS + pos->height[col]);
+}
+
+/* Orders the playable columns of a node, best candidates first:
+ * transposition table move, the two killer moves of this ply, then by
+ * history score. Ties keep the center-first order. Returns the count. */
+static int orderMoves(const SearchContext* ctx, const Position* pos, int depth,
+                      int ttMove, int moves[COLS]) {
+    int keys[COLS];
+    int side = pos->moves & 1;
+    int count = 0;
+    int col, key;
+    int i, j;
+
+    for (i = 0; i < COLS; i++) {
+        col = g_centerOrder[i];
+        if (!canPlayColumn(pos, col)) {
+            continue;
+        }
+        if (col == ttMove) {
+            key = ORDER_TT_MOVE;
+        } else if (col == ctx->killers[depth][0]) {
+            key = ORDER_KILLER_1;
+        } else if (col == ctx->killers[depth][1]) {
+            key = ORDER_KILLER_2;
+        } else {
+            key = ctx->history[side][col * ROWS + pos->height[col]];
+        }
+
+        /* Insertion sort, stable so equal keys stay center-first */
+        j = count;
+        while (j > 0 && keys[j - 1] < key) {
+            keys[j] = keys[j - 1];
+            moves[j] = moves[j - 1];
+            j--;
+        }
+        keys[j] = key;
+        moves[j] = col;
+        count++;
+    }
+    return count;
+}
+
+/* Updates killer moves and history after col caused a beta cutoff */
+static void recordCutoff(SearchContext* ctx, const Position* pos, int depth,
+                         int remaining, int col) {
+    int* history = &ctx->history[pos->moves & 1][col * ROWS + pos->height[col]];
+
+    if (ctx->killers[depth][0] != col) {
+        ctx->killers[depth][1] = ctx->killers[depth][0];
+        ctx->killers[depth][0] = col;
+    }
+
+    /* Deeper cutoffs say more about a move; halve all entries of the
+     * side before the counter could grow past the killer keys */
+    *history += remaining * remaining;
+    if (*history >= ORDER_HISTORY_MAX) {
+        int* sideHistory = ctx->history[pos->moves & 1];
+        int cell;
+        for (cell = 0; cell < BOARD_CELLS; cell++) {
+            sideHistory[cell] /= 2;
+        }
+    }
+}
+
+/* Minimax algorithm with alpha-beta pruning for Hard difficulty.
+ * Written in negamax form: the score is always from the point of view
+ * of the side to move, so each child score is negated.
+ * Moves are made and unmade on pos itself, no board is copied. */
+int minimaxAlgorithm(SearchContext* ctx, Position* pos, int depth, int alpha, int beta) {
+    TTEntry entry;
+    int moves[COLS];
+    int moveCount;
+    int ttMove = -1;
+    int i;
+    int col;
+    int eval;
+    int bestEval;
+    int bestMove = -1;
+    int alphaOriginal = alpha;
+    int remaining = ctx->maxDepth - depth;
+    int flag;
+
+    countNode(ctx);
+    if (ctx->stopped) {
+        return 0;  /* Result is thrown away by the driver */
+    }
+    if (depth > ctx->maxPly) {
+        ctx->maxPly = depth;
+    }
+
+    /* Terminal conditions - a move that wins right now ends the search.
+     * Wins are tested before playing, so no child is generated for them. */
+    for (col = 0; col < COLS; col++) {
+        if (canPlayColumn(pos, col) && isWinningMove(pos, col)) {
+            return WIN_SCORE - (depth + 1);
+        }
+    }
+    if (pos->moves == BOARD_CELLS) {
+        return 0;  /* Draw */
+    }
+    if (depth >= ctx->maxDepth) {
+        ctx->leafEvaluations++;
+        return evaluateBoardState(&ctx->eval, pos);
+    }
+
+    /* Transposition table: reuse a result searched at least as deep,
+     * otherwise at least try its best move first */
+    ctx->ttProbes++;
+    if (probeTranspositionTable(pos->hash, &entry)) {
+        ctx->ttHits++;
+        ttMove = entry.bestMove;
+        if (entry.depth >= remaining) {
+            eval = scoreFromTable(entry.score, depth);
+            if (entry.flag == TT_EXACT) {
+                return eval;
+            }
+            if (entry.flag == TT_LOWER && eval > alpha) {
+                alpha = eval;
+            } else if (entry.flag == TT_UPPER && eval < beta) {
+                beta = eval;
+            }
+            if (alpha >= beta) {
+                return eval;
+            }
+        }
+    }
+
+    moveCount = orderMoves(ctx, pos, depth, ttMove, moves);
+
+    bestEval = -INFINITE_SCORE;
+    for (i = 0; i < moveCount; i++) {
+        col = moves[i];
+        makeMove(ctx, pos, col);
+        eval = -minimaxAlgorithm(ctx, pos, depth + 1, -beta, -alpha);
+        unmakeMove(ctx, pos);
+        if (eval > bestEval) {
+            bestEval = eval;
+            bestMove = col;
+        }
+        if (eval > alpha) {
+            alpha = eval;
+        }
+        if (alpha >= beta) {
+            /* Alpha-beta pruning: remember the move that caused it */
+            ctx->cutoffs++;
+            if (i == 0) {
+                ctx->firstMoveCutoffs++;
+            }
+            recordCutoff(ctx, pos, depth, remaining, col);
+            break;
+        }
+    }
+
+    /* An interrupted search has no trustworthy result to store */
+    if (ctx->stopped) {
+        return 0;
+    }
+
+    /* Remember the result and what kind of bound it is */
+    if (bestEval <= alphaOriginal) {
+        flag = TT_UPPER;
+    } else if (bestEval >= beta) {
+        flag = TT_LOWER;
+    } else {
+        flag = TT_EXACT;
+    }
+    storeTranspositionTable(pos->hash, remaining, scoreToTable(bestEval, depth), flag, bestMove);
+
+    return bestEval;
+}
+
+/* Searches every root move in the given order with a shared window.
+ * Returns the best score and writes the best column to bestMove. */
+static int searchRoot(SearchContext* ctx, Position* pos, const int order[COLS], int* bestMove) {
+    int alpha = -INFINITE_SCORE;
+    int score;
+    int i;
+
+    *bestMove = -1;
+    for (i = 0; i < COLS; i++) {
+        if (!canPlayColumn(pos, order[i])) {
+            continue;
+        }
+        makeMove(ctx, pos, order[i]);
+        score = -minimaxAlgorithm(ctx, pos, 1, -INFINITE_SCORE, -alpha);
+        unmakeMove(ctx, pos);
+        if (ctx->stopped) {
+            break;
+        }
+        if (score > alpha) {
+            alpha = score;
+            *bestMove = order[i];
+        }
+    }
+    return alpha;
+}
+
+/* Returns 1 if after playing col the opponent can win immediately */
+static int givesImmediateWin(Position* pos, int col) {
+    int reply;
+    int found = 0;
+
+    playColumn(pos, col);
+    for (reply = 0; reply < COLS && !found; reply++) {
+        if (canPlayColumn(pos, reply) && isWinningMove(pos, reply)) {
+            found = 1;
+        }
+    }
+    undoColumn(pos, col);
+    return found;
+}
+
+/* Moves col to the front of the order, keeping the rest as it was */
+static void moveToFront(int order[COLS], int col) {
+    int i = 0;
+
+    while (order[i] != col) {
+        i++;
+    }
+    while (i > 0) {
+        order[i] = order[i - 1];
+        i--;
+    }
+    order[0] = col;
+}
+
+/* Follows the best moves stored in the transposition table from the
+ * root, up to maxLength moves or until a move wins or is missing.
+ * Returns the length of the variation written to pv. */
+static int extractPrincipalVariation(const Position* rootPos, int bestMove,
+                                     int maxLength, int pv[BOARD_CELLS]) {
+    Position pos = *rootPos;
+    TTEntry entry;
+    int length = 0;
+    int move = bestMove;
+    int col;
+
+    while (length < maxLength && canPlayColumn(&pos, move)) {
+        pv[length] = move;
+        length++;
+        if (isWinningMove(&pos, move)) {
+            break;  /* The game ends here */
+        }
+        playColumn(&pos, move);
+
+        /* Nodes with a winning move are never stored: find it directly */
+        move = -1;
+        for (col = 0; col < COLS && move == -1; col++) {
+            if (canPlayColumn(&pos, col) && isWinningMove(&pos, col)) {
+                move = col;
+            }
+        }
+        if (move == -1) {
+            if (!probeTranspositionTable(pos.hash, &entry)) {
+                break;
+            }
+            move = entry.bestMove;
+        }
+    }
+    return length;
+}
+
+/* Sets up a search context for one thread searching pos */
+static void initContext(SearchContext* ctx, const Position* pos, long long nodeLimit,
+                        long long deadline, volatile int* sharedStop) {
+    ctx->maxDepth = 0;
+    ctx->nodes = 0;
+    ctx->nodeLimit = nodeLimit;
+    ctx->deadline = deadline;
+    ctx->stopped = 0;
+    ctx->sharedStop = sharedStop;
+    ctx->ttProbes = 0;
+    ctx->ttHits = 0;
+    ctx->cutoffs = 0;
+    ctx->firstMoveCutoffs = 0;
+    ctx->leafEvaluations = 0;
+    ctx->maxPly = 0;
+    ctx->stackSize = 0;
+    memset(ctx->killers, -1, sizeof(ctx->killers));
+    memset(ctx->history, 0, sizeof(ctx->history));
+    initEvaluator(&ctx->eval, pos);
+}
+
+/* Work item of a Lazy SMP helper thread */
+typedef struct {
+    SearchContext ctx;
+    Position pos;
+    int order[COLS];
+    int firstDepth;
+    int maxDepth;
+    Thread thread;
+} HelperSearch;
+
+/* Helper thread: same iterations as the main thread, but with its own
+ * root order and every other helper one ply ahead. It only fills the
+ * shared table; its results are never used directly. */
+static void helperSearchThread(void* arg) {
+    HelperSearch* helper = (HelperSearch*)arg;
+    int depth;
+    int move;
+
+    for (depth = helper->firstDepth; depth <= helper->maxDepth; depth++) {
+        helper->ctx.maxDepth = depth;
+        searchRoot(&helper->ctx, &helper->pos, helper->order, &move);
+        if (helper->ctx.stopped) {
+            break;
+        }
+    }
+}
+
+/* Iterative deepening driver: searches depth 1, 2, 3... until the time
+ * or node budget runs out. Each finished iteration puts its best move
+ * first in the order of the next one. */
+int searchPosition(const Position* rootPos, const SearchLimits* limits, SearchResult* result) {
+    HelperSearch* helpers = NULL;
+    SearchContext ctx;
+    Position position = *rootPos;  /* The one copy the whole search works on */
+    Position* pos = &position;
+    long long start = getTimeMicros();
+    long long deadline = 0;
+    volatile int stopHelpers = 0;
+    int order[COLS];
+    int threads;
+    int maxDepth;
+    int depth;
+    int score;
+    int move;
+    int nonLosing = 0;
+    int i, j;
+
+    result->bestMove = -1;
+    result->score = 0;
+    result->depth = 0;
+    result->nodes = 0;
+    result->cutoffs = 0;
+    result->firstMoveCutoffs = 0;
+    result->leafEvaluations = 0;
+    result->maxPly = 0;
+    result->ttProbes = 0;
+    result->ttHits = 0;
+    result->pvLength = 0;
+    result->threads = 1;
+
+    for (i = 0; i < COLS; i++) {
+        order[i] = g_centerOrder[i];
+    }
+
+    /* Immediate win: nothing to search */
+    for (i = 0; i < COLS; i++) {
+        if (canPlayColumn(pos, order[i]) && isWinningMove(pos, order[i])) {
+            result->bestMove = order[i];
+            result->score = WIN_SCORE - 1;
+            result->depth = 1;
+            result->pv[0] = order[i];
+            result->pvLength = 1;
+            result->elapsedMicros = getTimeMicros() - start;
+            return result->bestMove;
+        }
+    }
+
+    /* Fallback move: first column that does not hand over a win */
+    for (i = 0; i < COLS; i++) {
+        if (canPlayColumn(pos, order[i]) && !givesImmediateWin(pos, order[i])) {
+            if (nonLosing == 0) {
+                result->bestMove = order[i];
+            }
+            nonLosing++;
+        }
+    }
+    if (nonLosing <= 1) {
+        /* Forced move (or every move loses): answer at once */
+        if (result->bestMove == -1) {
+            for (i = 0; i < COLS && result->bestMove == -1; i++) {
+                if (canPlayColumn(pos, order[i])) {
+                    result->bestMove = order[i];
+                }
+            }
+        }
+        result->depth = 1;
+        if (result->bestMove != -1) {
+            result->pv[0] = result->bestMove;
+            result->pvLength = 1;
+        }
+        result->elapsedMicros = getTimeMicros() - start;
+        return result->bestMove;
+    }
+
+    if (limits->timeLimitMs > 0) {
+        deadline = start + (long long)limits->timeLimitMs * 1000;
+    }
+    initContext(&ctx, pos, limits->nodeLimit, deadline, limits->stop);
+    newSearchGeneration();
+
+    /* No point searching past the last empty cell */
+    maxDepth = BOARD_CELLS - pos->moves;
+    if (limits->maxDepth > 0 && limits->maxDepth < maxDepth) {
+        maxDepth = limits->maxDepth;
+    }
+
+    /* Start the helpers (Lazy SMP), each with a rotated root order */
+    threads = limits->threads;
+    if (threads < 1) {
+        threads = 1;
+    }
+    if (threads > MAX_SEARCH_THREADS) {
+        threads = MAX_SEARCH_THREADS;
+    }
+    if (threads > 1) {
+        helpers = (HelperSearch*)calloc((size_t)threads, sizeof(HelperSearch));
+        if (helpers == NULL) {
+            threads = 1;
+        }
+    }
+    for (i = 1; i < threads; i++) {
+        helpers[i].pos = *rootPos;
+        initContext(&helpers[i].ctx, &helpers[i].pos, 0, deadline, &stopHelpers);
+        for (j = 0; j < COLS; j++) {
+            helpers[i].order[j] = g_centerOrder[(j + i) % COLS];
+        }
+        helpers[i].firstDepth = 1 + (i & 1);
+        helpers[i].maxDepth = maxDepth;
+        if (!createThread(&helpers[i].thread, helperSearchThread, &helpers[i])) {
+            break;  /* Carry on with the threads we have */
+        }
+    }
+    threads = i;
+    result->threads = threads;
+
+    for (depth = 1; depth <= maxDepth; depth++) {
+        ctx.maxDepth = depth;
+        score = searchRoot(&ctx, pos, order, &move);
+        if (ctx.stopped || move == -1) {
+            break;  /* Unfinished iteration: keep the previous answer */
+        }
+
+        result->bestMove = move;
+        result->score = score;
+        result->depth = depth;
+        moveToFront(order, move);
+
+        /* A forced win or loss will not change with more depth */
+        if (score > WIN_THRESHOLD || score < -WIN_THRESHOLD) {
+            break;
+        }
+        /* The next iteration costs several times this one: do not start
+         * it when more than half of the budget is already gone */
+        if (deadline > 0 && (getTimeMicros() - start) * 2 > (deadline - start)) {
+            break;
+        }
+    }
+
+    /* Stop and collect the helpers */
+    stopHelpers = 1;
+    result->nodes = ctx.nodes;
+    result->cutoffs = ctx.cutoffs;
+    result->firstMoveCutoffs = ctx.firstMoveCutoffs;
+    result->leafEvaluations = ctx.leafEvaluations;
+    result->maxPly = ctx.maxPly;
+    result->ttProbes = ctx.ttProbes;
+    result->ttHits = ctx.ttHits;
+    for (i = 1; i < threads; i++) {
+        joinThread(&helpers[i].thread);
+        result->nodes += helpers[i].ctx.nodes;
+        result->leafEvaluations += helpers[i].ctx.leafEvaluations;
+        result->ttProbes += helpers[i].ctx.ttProbes;
+        result->ttHits += helpers[i].ctx.ttHits;
+        if (helpers[i].ctx.maxPly > result->maxPly) {
+            result->maxPly = helpers[i].ctx.maxPly;
+        }
+    }
+    recordTranspositionStats(result->ttProbes, result->ttHits);
+    free(helpers);
+
+    if (result->bestMove != -1) {
+        result->pvLength = extractPrincipalVariation(rootPos, result->bestMove,
+                                                     result->depth > 0 ? result->depth : 1,
+                                                     result->pv);
+    }
+
+    result->elapsedMicros = getTimeMicros() - start;
+    return result->bestMove;
+}
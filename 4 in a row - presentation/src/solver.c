@@ -0,0 +1,304 @@
+/*
+ * solver.c - Connect Four solver implementation
+ * Negamax with alpha-beta on bitboards, non-losing move pruning,
+ * threat-based move ordering, a compact transposition table, and an
+ * iterated null-window search (MTD style) to narrow down the score.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "../include/solver.h"
+#include "../include/threads.h"
+
+/* Transposition table size: a prime, so (key mod size, low 32 bits of
+ * key) identify the 49-bit key exactly. About 64 MB. */
+#define SOLVER_TABLE_SIZE 8388593
+
+/* Column order tried first: center */
+static const int g_solverOrder[COLS] = {3, 2, 4, 1, 5, 0, 6};
+
+/* Transposition table of upper bounds. One 64-bit word per slot holds
+ * the low 32 key bits and the value, so threads solving at the same
+ * time can never read a key with another position's value. */
+static volatile uint64_t* g_solverTable = NULL;
+
+/* Nodes searched by the running solve of this thread */
+static THREAD_LOCAL long long g_solverNodes = 0;
+
+/* Allocates the transposition table, returns 1 if it is available */
+int initSolver(void) {
+    if (g_solverTable == NULL) {
+        g_solverTable = (volatile uint64_t*)calloc(SOLVER_TABLE_SIZE, sizeof(uint64_t));
+    }
+    return g_solverTable != NULL;
+}
+
+/* Stores an upper bound (value 0 means "empty slot") */
+static void solverTablePut(uint64_t key, int value) {
+    size_t index = (size_t)(key % SOLVER_TABLE_SIZE);
+    g_solverTable[index] = ((key & 0xFFFFFFFFULL) << 8) | (uint64_t)value;
+}
+
+/* Reads an upper bound, 0 if the key is not stored */
+static int solverTableGet(uint64_t key) {
+    size_t index = (size_t)(key % SOLVER_TABLE_SIZE);
+    uint64_t slot = g_solverTable[index];
+    if ((slot >> 8) == (key & 0xFFFFFFFFULL)) {
+        return (int)(slot & 0xFF);
+    }
+    return 0;
+}
+
+/* Score of a win with the next disc */
+static int immediateWinScore(const Position* pos) {
+    return (BOARD_CELLS + 1 - pos->moves) / 2;
+}
+
+/* Returns a column the side to move can win with right now, or -1 */
+static int findWinningColumn(const Position* pos) {
+    Bitboard wins = winningCells(pos->current, pos->mask) & playableCells(pos);
+    int col;
+
+    for (col = 0; col < COLS && wins; col++) {
+        if (wins & columnMask(col)) {
+            return col;
+        }
+    }
+    return -1;
+}
+
+/* Sorts the non-losing moves by how many winning cells they create,
+ * ties stay center-first. Returns the number of moves. */
+static int sortSolverMoves(const Position* pos, Bitboard next, int moves[COLS]) {
+    int keys[COLS];
+    int count = 0;
+    int col, key;
+    int i, j;
+
+    for (i = 0; i < COLS; i++) {
+        col = g_solverOrder[i];
+        if ((next & columnMask(col)) == 0) {
+            continue;
+        }
+        key = countBits(winningCells(pos->current | (next & columnMask(col)), pos->mask));
+
+        j = count;
+        while (j > 0 && keys[j - 1] < key) {
+            keys[j] = keys[j - 1];
+            moves[j] = moves[j - 1];
+            j--;
+        }
+        keys[j] = key;
+        moves[j] = col;
+        count++;
+    }
+    return count;
+}
+
+/* Negamax with alpha-beta. The side to move must not have an immediate
+ * win. Returns the exact score if it lies inside (alpha, beta), an upper
+ * bound if <= alpha, a lower bound if >= beta. */
+static int solverNegamax(Position* pos, int alpha, int beta) {
+    Bitboard next;
+    int moves[COLS];
+    int count;
+    int minScore, maxScore;
+    int value;
+    int score;
+    int i;
+
+    g_solverNodes++;
+
+    next = nonLosingMoves(pos);
+    if (next == 0) {
+        return -(BOARD_CELLS - pos->moves) / 2;  /* Opponent wins next move */
+    }
+    if (pos->moves >= BOARD_CELLS - 2) {
+        return 0;  /* Nobody can win in the last two moves */
+    }
+
+    /* Lower bound: we can not lose before the opponent's next-next disc */
+    minScore = -(BOARD_CELLS - 2 - pos->moves) / 2;
+    if (alpha < minScore) {
+        alpha = minScore;
+        if (alpha >= beta) {
+            return alpha;
+        }
+    }
+
+    /* Upper bound: we can not win with our next disc, or the table knows */
+    maxScore = (BOARD_CELLS - 1 - pos->moves) / 2;
+    value = solverTableGet(positionKey(pos));
+    if (value != 0) {
+        maxScore = value + SOLVER_MIN_SCORE - 1;
+    }
+    if (beta > maxScore) {
+        beta = maxScore;
+        if (alpha >= beta) {
+            return beta;
+        }
+    }
+
+    count = sortSolverMoves(pos, next, moves);
+    for (i = 0; i < count; i++) {
+        playColumn(pos, moves[i]);
+        score = -solverNegamax(pos, -beta, -alpha);
+        undoColumn(pos, moves[i]);
+        if (score >= beta) {
+            return score;
+        }
+        if (score > alpha) {
+            alpha = score;
+        }
+    }
+
+    solverTablePut(positionKey(pos), alpha - SOLVER_MIN_SCORE + 1);
+    return alpha;
+}
+
+/* Exact score by repeated null-window searches that halve the range */
+static int solveScore(Position* pos) {
+    int minScore, maxScore, middle, r;
+
+    if (findWinningColumn(pos) != -1) {
+        return immediateWinScore(pos);
+    }
+
+    minScore = -(BOARD_CELLS - pos->moves) / 2;
+    maxScore = (BOARD_CELLS + 1 - pos->moves) / 2;
+    while (minScore < maxScore) {
+        middle = minScore + (maxScore - minScore) / 2;
+        /* Probe near zero first: most positions are decided early */
+        if (middle <= 0 && minScore / 2 < middle) {
+            middle = minScore / 2;
+        } else if (middle >= 0 && maxScore / 2 > middle) {
+            middle = maxScore / 2;
+        }
+        r = solverNegamax(pos, middle, middle + 1);
+        if (r <= middle) {
+            maxScore = r;
+        } else {
+            minScore = r;
+        }
+    }
+    return minScore;
+}
+
+/* Plies until the end of the game for a given score */
+static int pliesForScore(int moves, int score) {
+    int winnerMoves;   /* Discs on the board when the winning disc falls */
+    int moverParity;
+
+    if (score == 0) {
+        return BOARD_CELLS - moves;
+    }
+    if (score > 0) {
+        moverParity = moves & 1;
+    } else {
+        moverParity = (moves + 1) & 1;
+        score = -score;
+    }
+    /* score = (BOARD_CELLS + 1 - winnerMoves) / 2 with the winner's parity */
+    winnerMoves = BOARD_CELLS + 1 - 2 * score;
+    if ((winnerMoves & 1) != moverParity) {
+        winnerMoves--;
+    }
+    return winnerMoves - moves + 1;
+}
+
+/* Solves a position exactly */
+int solve(const Position* rootPos, SolveResult* result) {
+    Position position = *rootPos;
+    Position* pos = &position;
+    Bitboard next;
+    int moves[COLS];
+    int count;
+    int col;
+    int i;
+
+    g_solverNodes = 0;
+    result->bestMove = -1;
+    result->score = 0;
+
+    if (!initSolver()) {
+        result->outcome = SOLVE_DRAW;
+        result->pliesToEnd = 0;
+        result->nodes = 0;
+        return 0;
+    }
+
+    if (pos->moves >= BOARD_CELLS) {
+        result->outcome = SOLVE_DRAW;
+        result->pliesToEnd = 0;
+        result->nodes = 0;
+        return 0;
+    }
+
+    col = findWinningColumn(pos);
+    if (col != -1) {
+        result->score = immediateWinScore(pos);
+        result->bestMove = col;
+    } else {
+        result->score = solveScore(pos);
+
+        /* Find a move that reaches the score: child score <= -score */
+        next = nonLosingMoves(pos);
+        count = sortSolverMoves(pos, next, moves);
+        for (i = 0; i < count && result->bestMove == -1; i++) {
+            playColumn(pos, moves[i]);
+            if (solverNegamax(pos, -result->score, -result->score + 1) <= -result->score) {
+                result->bestMove = moves[i];
+            }
+            undoColumn(pos, moves[i]);
+        }
+        /* Lost position (or no non-losing move): any playable column */
+        for (i = 0; i < COLS && result->bestMove == -1; i++) {
+            if (canPlayColumn(pos, g_solverOrder[i])) {
+                result->bestMove = g_solverOrder[i];
+            }
+        }
+    }
+
+    if (result->score > 0) {
+        result->outcome = SOLVE_WIN;
+    } else if (result->score < 0) {
+        result->outcome = SOLVE_LOSS;
+    } else {
+        result->outcome = SOLVE_DRAW;
+    }
+    result->pliesToEnd = pliesForScore(pos->moves, result->score);
+    result->nodes = g_solverNodes;
+    return result->score;
+}
+
+/* Exact score of every column */
+void solveAllMoves(const Position* rootPos, int scores[COLS]) {
+    Position position = *rootPos;
+    int col;
+
+    if (!initSolver()) {
+        for (col = 0; col < COLS; col++) {
+            scores[col] = INVALID_SOLVER_SCORE;
+        }
+        return;
+    }
+
+    for (col = 0; col < COLS; col++) {
+        if (!canPlayColumn(&position, col)) {
+            scores[col] = INVALID_SOLVER_SCORE;
+        } else if (isWinningMove(&position, col)) {
+            scores[col] = immediateWinScore(&position);
+        } else {
+            playColumn(&position, col);
+            scores[col] = -solveScore(&position);
+            undoColumn(&position, col);
+        }
+    }
+}
+
+/* Empties the solver's transposition table */
+void resetSolver(void) {
+    if (g_solverTable != NULL) {
+        memset((void*)g_solverTable, 0, SOLVER_TABLE_SIZE * sizeof(uint64_t));
+    }
+}
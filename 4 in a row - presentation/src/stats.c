@@ -1,13 +1,27 @@
 /*
  * stats.c - Game Statistics implementation
  * Handles tracking and storing game statistics
+ * Every game is appended to the game log; the counts are rebuilt at
+ * startup from the last checkpoint plus the records logged after it.
  */
 
 #include <stdio.h>
+#include <stddef.h>
 #include <string.h>
 #include "../include/stats.h"
 #include "../include/ui.h"
 
+/* Log of finished games and the files of this session */
+static GameLog g_gameLog;
+static const char* g_checkpointFile = NULL;
+static const char* g_logFile = NULL;
+
+/* Games logged since the last checkpoint */
+static int g_gamesSinceCheckpoint = 0;
+
+/* Name a damaged log was moved to at startup ("" if none) */
+static char g_damagedLogFile[FILENAME_MAX] = "";
+
 /* Initializes all statistics to zero */
 void initStats(GameStats* stats) {
     stats->player1Wins = 0;
@@ -50,48 +64,210 @@ void displayStats(GameStats* stats) {
     displayTitle();
     
     setColor(COLOR_GREEN);
-    printf("\n  Game Statistics:\n");
+    framePrintf("\n  Game Statistics:\n");
     setColor(COLOR_DEFAULT);
-    printf("  ================================\n");
-    printf("  Total Games Played: %d\n", stats->totalGames);
-    printf("  --------------------------------\n");
+    framePrintf("  ================================\n");
+    framePrintf("  Total Games Played: %d\n", stats->totalGames);
+    framePrintf("  --------------------------------\n");
     
     setColor(COLOR_CYAN);
-    printf("  Player vs Player:\n");
+    framePrintf("  Player vs Player:\n");
     setColor(COLOR_DEFAULT);
-    printf("    Player 1 Wins: %d\n", stats->player1Wins);
-    printf("    Player 2 Wins: %d\n", stats->player2Wins);
+    framePrintf("    Player 1 Wins: %d\n", stats->player1Wins);
+    framePrintf("    Player 2 Wins: %d\n", stats->player2Wins);
     
     setColor(COLOR_CYAN);
-    printf("\n  Player vs Computer:\n");
+    framePrintf("\n  Player vs Computer:\n");
     setColor(COLOR_DEFAULT);
-    printf("    Human Wins:    %d\n", stats->humanWins);
-    printf("    Computer Wins: %d\n", stats->computerWins);
+    framePrintf("    Human Wins:    %d\n", stats->humanWins);
+    framePrintf("    Computer Wins: %d\n", stats->computerWins);
     
     setColor(COLOR_CYAN);
-    printf("\n  Ties: %d\n", stats->ties);
+    framePrintf("\n  Ties: %d\n", stats->ties);
     setColor(COLOR_DEFAULT);
-    printf("  ================================\n\n");
+    framePrintf("  ================================\n\n");
 }
 
-/* Saves statistics to file */
-void saveStats(GameStats* stats, const char* filename) {
-    FILE* file = fopen(filename, "wb");
+/* Counts one logged game */
+static void countGameRecord(const GameRecord* record, void* context) {
+    GameStats* stats = (GameStats*)context;
+
+    if (record->mode == MODE_PVP) {
+        updatePvPStats(stats, record->winner);
+    } else if (record->winner == PLAYER1) {
+        updatePvCStats(stats, 1);   /* The human plays first */
+    } else if (record->winner == PLAYER2) {
+        updatePvCStats(stats, 0);
+    } else {
+        updatePvCStats(stats, -1);
+    }
+}
+
+/* Returns the size of a file in bytes, 0 if it does not exist */
+static long long fileSize(const char* filename) {
+    FILE* file = fopen(filename, "rb");
+    long long size = 0;
+
     if (file != NULL) {
-        fwrite(stats, sizeof(GameStats), 1, file);
+        if (fseek(file, 0, SEEK_END) == 0) {
+            size = (long long)ftell(file);
+        }
         fclose(file);
     }
+    return size;
 }
 
-/* Loads statistics from file */
-void loadStats(GameStats* stats, const char* filename) {
+/* Reads a checkpoint, returns the log offset its counts include.
+ * A file from older versions (a bare GameStats) counts as offset 0. */
+static long long readCheckpoint(GameStats* stats, const char* filename) {
+    StatsCheckpoint checkpoint;
     FILE* file = fopen(filename, "rb");
-    if (file != NULL) {
-        if (fread(stats, sizeof(GameStats), 1, file) != 1) {
-            initStats(stats);  /* Reset if read fails */
+    size_t size;
+
+    initStats(stats);
+    if (file == NULL) {
+        return 0;
+    }
+    memset(&checkpoint, 0, sizeof(checkpoint));
+    size = fread(&checkpoint, 1, sizeof(checkpoint), file);
+    fclose(file);
+
+    if (size == sizeof(checkpoint) && checkpoint.magic == STATS_MAGIC &&
+        checkpoint.version == STATS_VERSION &&
+        checkpoint.checksum == checksumBytes(&checkpoint, offsetof(StatsCheckpoint, checksum))) {
+        *stats = checkpoint.stats;
+        return checkpoint.logOffset;
+    }
+    if (size == sizeof(GameStats)) {
+        memcpy(stats, &checkpoint, sizeof(GameStats));
+    }
+    return 0;
+}
+
+/* Renames a damaged log to the first free "<log>.damaged" name, so
+ * none of its records are lost, returns 1 on success */
+static int moveLogAside(const char* logFile) {
+    FILE* file;
+    int i;
+
+    for (i = 0; i < 100; i++) {
+        if (i == 0) {
+            sprintf(g_damagedLogFile, "%.*s.damaged", FILENAME_MAX - 12, logFile);
+        } else {
+            sprintf(g_damagedLogFile, "%.*s.damaged%d", FILENAME_MAX - 12, logFile, i);
+        }
+        file = fopen(g_damagedLogFile, "rb");
+        if (file == NULL) {
+            if (rename(logFile, g_damagedLogFile) == 0) {
+                return 1;
+            }
+            break;
         }
         fclose(file);
-    } else {
-        initStats(stats);  /* Initialize if file doesn't exist */
     }
+    g_damagedLogFile[0] = '\0';
+    return 0;
+}
+
+/* Returns the name a damaged log was moved to by loadStats, NULL if none */
+const char* getDamagedLogFile(void) {
+    return g_damagedLogFile[0] != '\0' ? g_damagedLogFile : NULL;
+}
+
+/* Rebuilds statistics from a checkpoint and the game log records after
+ * it, and opens the log for new games. Returns 0 if the log is damaged
+ * somewhere other than a torn last record. */
+int loadStats(GameStats* stats, const char* checkpointFile, const char* logFile) {
+    long long offset;
+    long long end;
+    int damaged;
+
+    g_checkpointFile = checkpointFile;
+    g_logFile = logFile;
+    g_gamesSinceCheckpoint = 0;
+
+    offset = readCheckpoint(stats, checkpointFile);
+    if (fileSize(logFile) < offset) {
+        /* The log was replaced: count all of it from scratch */
+        initStats(stats);
+        offset = 0;
+    }
+
+    end = readGameLog(logFile, offset, countGameRecord, stats);
+    if (offset > 0 && end == offset && checkGameLogTail(logFile, end) == LOG_TAIL_DAMAGED) {
+        /* The checkpoint points into a record: not the log it was taken
+         * from, count all of it from scratch */
+        initStats(stats);
+        end = readGameLog(logFile, 0, countGameRecord, stats);
+    }
+
+    /* Damage is never cut off: the log is kept under another name and
+     * new games go to a fresh one. If it can not be moved, openGameLog
+     * refuses to open it and nothing is written. */
+    damaged = checkGameLogTail(logFile, end) == LOG_TAIL_DAMAGED;
+    if (damaged && moveLogAside(logFile)) {
+        end = 0;
+    }
+    openGameLog(&g_gameLog, logFile, end);
+    if (damaged && g_gameLog.file != NULL) {
+        saveStats(stats);  /* The counts so far, at offset 0 of the new log */
+    }
+    return !damaged;
+}
+
+/* Logs a finished game and counts it */
+void recordGame(GameStats* stats, GameRecord* record) {
+    appendGameRecord(&g_gameLog, record);
+    countGameRecord(record, stats);
+
+    g_gamesSinceCheckpoint++;
+    if (g_gamesSinceCheckpoint >= STATS_CHECKPOINT_INTERVAL) {
+        saveStats(stats);
+    }
+}
+
+/* Writes a checkpoint of the statistics (to a temporary file that then
+ * replaces the old one, so a crash leaves one or the other) */
+void saveStats(const GameStats* stats) {
+    StatsCheckpoint checkpoint;
+    char tempFile[FILENAME_MAX];
+    FILE* file;
+
+    if (g_checkpointFile == NULL || g_gameLog.file == NULL) {
+        return;
+    }
+
+    /* The checkpoint must never count records that are not on disk */
+    syncGameLog(&g_gameLog);
+
+    memset(&checkpoint, 0, sizeof(checkpoint));
+    checkpoint.magic = STATS_MAGIC;
+    checkpoint.version = STATS_VERSION;
+    checkpoint.stats = *stats;
+    checkpoint.logOffset = getGameLogSize(&g_gameLog);
+    checkpoint.checksum = checksumBytes(&checkpoint, offsetof(StatsCheckpoint, checksum));
+
+    sprintf(tempFile, "%.*s.tmp", FILENAME_MAX - 5, g_checkpointFile);
+    file = fopen(tempFile, "wb");
+    if (file == NULL) {
+        return;
+    }
+    if (fwrite(&checkpoint, sizeof(checkpoint), 1, file) != 1) {
+        fclose(file);
+        remove(tempFile);
+        return;
+    }
+    fclose(file);
+#ifdef _WIN32
+    remove(g_checkpointFile);   /* rename() does not replace files on Windows */
+#endif
+    if (rename(tempFile, g_checkpointFile) == 0) {
+        g_gamesSinceCheckpoint = 0;
+    }
+}
+
+/* Writes a checkpoint and closes the log */
+void closeStats(const GameStats* stats) {
+    saveStats(stats);
+    closeGameLog(&g_gameLog);
 }
@@ -0,0 +1,52 @@
+/*
+ * threads.c - Thread helper implementation
+ * Windows threads on _WIN32, pthreads everywhere else
+ */
+
+#include "../include/threads.h"
+
+#ifdef _WIN32
+
+/* Adapts the Windows thread signature to ThreadFunction */
+static DWORD WINAPI threadStart(LPVOID param) {
+    Thread* thread = (Thread*)param;
+    thread->function(thread->arg);
+    return 0;
+}
+
+/* Starts function(arg) on a new thread */
+int createThread(Thread* thread, ThreadFunction function, void* arg) {
+    thread->function = function;
+    thread->arg = arg;
+    thread->handle = CreateThread(NULL, 0, threadStart, thread, 0, NULL);
+    return thread->handle != NULL;
+}
+
+/* Waits for a thread to finish */
+void joinThread(Thread* thread) {
+    WaitForSingleObject(thread->handle, INFINITE);
+    CloseHandle(thread->handle);
+}
+
+#else
+
+/* Adapts the pthread signature to ThreadFunction */
+static void* threadStart(void* param) {
+    Thread* thread = (Thread*)param;
+    thread->function(thread->arg);
+    return NULL;
+}
+
+/* Starts function(arg) on a new thread */
+int createThread(Thread* thread, ThreadFunction function, void* arg) {
+    thread->function = function;
+    thread->arg = arg;
+    return pthread_create(&thread->handle, NULL, threadStart, thread) == 0;
+}
+
+/* Waits for a thread to finish */
+void joinThread(Thread* thread) {
+    pthread_join(thread->handle, NULL);
+}
+
+#endif
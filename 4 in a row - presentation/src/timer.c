@@ -0,0 +1,33 @@
+/*
+ * timer.c - Wall-clock timer implementation
+ * Uses QueryPerformanceCounter on Windows, clock_gettime elsewhere
+ */
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#define _POSIX_C_SOURCE 199309L
+#include <time.h>
+#endif
+#include "../include/timer.h"
+
+/* Returns a monotonic time stamp in microseconds */
+long long getTimeMicros(void) {
+#ifdef _WIN32
+    static LARGE_INTEGER frequency;
+    LARGE_INTEGER counter;
+
+    if (frequency.QuadPart == 0) {
+        QueryPerformanceFrequency(&frequency);
+    }
+    QueryPerformanceCounter(&counter);
+    /* Split the division so the multiply can not overflow */
+    return (long long)(counter.QuadPart / frequency.QuadPart) * 1000000 +
+           (long long)(counter.QuadPart % frequency.QuadPart) * 1000000 / frequency.QuadPart;
+#else
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (long long)now.tv_sec * 1000000 + now.tv_nsec / 1000;
+#endif
+}
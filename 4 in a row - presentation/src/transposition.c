@@ -0,0 +1,160 @@
+/*
+ * transposition.c - Transposition table implementation
+ * Fixed-size lockless hash table, one entry per slot
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "../include/transposition.h"
+
+/* One slot: the data word and the key XOR-ed with it */
+typedef struct {
+    volatile uint64_t check;   /* key ^ data (0 = empty slot) */
+    volatile uint64_t data;    /* Packed score, depth, flag, move, generation */
+} TTSlot;
+
+/* Packed data layout */
+#define DATA_SCORE(d)      ((int)(int16_t)((d) & 0xFFFF))
+#define DATA_DEPTH(d)      ((int)(((d) >> 16) & 0xFF))
+#define DATA_FLAG(d)       ((int)(((d) >> 24) & 0x3))
+#define DATA_MOVE(d)       ((int)(((d) >> 26) & 0xF) - 1)
+#define DATA_GENERATION(d) ((uint8_t)(((d) >> 32) & 0xFF))
+
+/* Table storage */
+static TTSlot* g_table = NULL;
+static size_t g_tableMask = 0;     /* Number of entries - 1 */
+static uint8_t g_generation = 0;
+
+/* Counters for hit rate reporting */
+static long long g_probes = 0;
+static long long g_hits = 0;
+
+/* Packs an entry into one 64-bit word */
+static uint64_t packData(int depth, int score, int flag, int bestMove) {
+    return (uint64_t)(uint16_t)(int16_t)score |
+           ((uint64_t)(depth & 0xFF) << 16) |
+           ((uint64_t)(flag & 0x3) << 24) |
+           ((uint64_t)((bestMove + 1) & 0xF) << 26) |
+           ((uint64_t)g_generation << 32);
+}
+
+/* Allocates the table, entry count is a power of two */
+int initTranspositionTable(size_t sizeInMB) {
+    size_t bytes = sizeInMB * 1024 * 1024;
+    size_t entries = 1;
+
+    while (entries * 2 * sizeof(TTSlot) <= bytes) {
+        entries = entries * 2;
+    }
+
+    freeTranspositionTable();
+    g_table = (TTSlot*)calloc(entries, sizeof(TTSlot));
+    if (g_table == NULL) {
+        return 0;
+    }
+    g_tableMask = entries - 1;
+    g_generation = 0;
+    resetTranspositionStats();
+    return 1;
+}
+
+/* Releases the table memory */
+void freeTranspositionTable(void) {
+    free((void*)g_table);
+    g_table = NULL;
+    g_tableMask = 0;
+}
+
+/* Empties all entries and resets the counters */
+void clearTranspositionTable(void) {
+    if (g_table != NULL) {
+        memset((void*)g_table, 0, (g_tableMask + 1) * sizeof(TTSlot));
+    }
+    g_generation = 0;
+    resetTranspositionStats();
+}
+
+/* Starts a new search (allocates the default table on first use).
+ * Must be called before search threads are started. */
+void newSearchGeneration(void) {
+    if (g_table == NULL) {
+        initTranspositionTable(TT_DEFAULT_SIZE_MB);
+    }
+    g_generation++;
+}
+
+/* Looks up a hash, returns 1 and fills entry on a hit */
+int probeTranspositionTable(uint64_t key, TTEntry* entry) {
+    TTSlot* slot;
+    uint64_t check;
+    uint64_t data;
+
+    if (g_table == NULL) {
+        return 0;
+    }
+
+    slot = &g_table[key & g_tableMask];
+    check = slot->check;
+    data = slot->data;
+    if ((check ^ data) != key || check == 0) {
+        return 0;  /* Other position, empty, or torn by a concurrent write */
+    }
+
+    entry->score = DATA_SCORE(data);
+    entry->depth = DATA_DEPTH(data);
+    entry->flag = DATA_FLAG(data);
+    entry->bestMove = DATA_MOVE(data);
+    return 1;
+}
+
+/* Stores a search result.
+ * Replacement policy: an entry is overwritten when it is empty, holds the
+ * same position, comes from an older search, or was searched less deep. */
+void storeTranspositionTable(uint64_t key, int depth, int score, int flag, int bestMove) {
+    TTSlot* slot;
+    uint64_t oldCheck;
+    uint64_t oldData;
+    uint64_t data;
+
+    if (g_table == NULL) {
+        return;
+    }
+
+    slot = &g_table[key & g_tableMask];
+    oldCheck = slot->check;
+    oldData = slot->data;
+    if (oldCheck != 0 && (oldCheck ^ oldData) != key &&
+        DATA_GENERATION(oldData) == g_generation && DATA_DEPTH(oldData) > depth) {
+        return;  /* Keep the deeper result of this search */
+    }
+
+    data = packData(depth, score, flag, bestMove);
+    slot->data = data;
+    slot->check = key ^ data;
+}
+
+/* Adds probe and hit counts of a finished search to the totals */
+void recordTranspositionStats(long long probes, long long hits) {
+    g_probes += probes;
+    g_hits += hits;
+}
+
+/* Returns the hit rate in percent */
+double getTranspositionHitRate(void) {
+    if (g_probes == 0) {
+        return 0.0;
+    }
+    return 100.0 * (double)g_hits / (double)g_probes;
+}
+
+/* Returns the raw probe and hit counters */
+void getTranspositionStats(long long* probes, long long* hits) {
+    *probes = g_probes;
+    *hits = g_hits;
+}
+
+/* Resets the probe and hit counters */
+void resetTranspositionStats(void) {
+    g_probes = 0;
+    g_hits = 0;
+}
@@ -1,31 +1,58 @@
 /*
  * ui.c - User Interface implementation
  * Handles console display and user input
+ * All output goes into the renderer's frame buffer (render.h) and
+ * reaches the terminal in one write when input is read.
  */
 
 #include <stdio.h>
 #include <stdlib.h>
-#include <windows.h>
 #include "../include/ui.h"
 
-/* Clears the console screen */
+/* Longest input line that is read */
+#define INPUT_LINE_SIZE 64
+
+/* Reads a line with a number, returns 1 if it holds one.
+ * Quits the program when the input is closed. */
+static int readNumber(int* value) {
+    char line[INPUT_LINE_SIZE];
+    char* end;
+    long number;
+
+    flushFrame();
+    if (fgets(line, sizeof(line), stdin) == NULL) {
+        frameColor(COLOR_DEFAULT);
+        framePrintf("\n");
+        flushFrame();
+        exit(0);
+    }
+    frameInputEchoed();
+
+    number = strtol(line, &end, 10);
+    if (end == line) {
+        return 0;
+    }
+    *value = (int)number;
+    return 1;
+}
+
+/* Starts a new screen (cursor home, the renderer overwrites the old one) */
 void clearScreen(void) {
-    system("cls");
+    beginFrame();
 }
 
-/* Sets console text color using Windows API */
+/* Sets the text color of the following output */
 void setColor(int color) {
-    HANDLE hConsole = GetStdHandle(STD_OUTPUT_HANDLE);
-    SetConsoleTextAttribute(hConsole, color);
+    frameColor(color);
 }
 
 /* Displays the game title banner */
 void displayTitle(void) {
     setColor(COLOR_CYAN);
-    printf("\n");
-    printf("  ====================================\n");
-    printf("  |     CONNECT FOUR - 4 IN A ROW   |\n");
-    printf("  ====================================\n");
+    framePrintf("\n");
+    framePrintf("  ====================================\n");
+    framePrintf("  |     CONNECT FOUR - 4 IN A ROW   |\n");
+    framePrintf("  ====================================\n");
     setColor(COLOR_DEFAULT);
 }
 
@@ -33,55 +60,55 @@ void displayTitle(void) {
 void displayBoard(int board[ROWS][COLS]) {
     int row, col;
     
-    printf("\n");
+    framePrintf("\n");
     
     /* Column numbers */
     setColor(COLOR_GREEN);
-    printf("    ");
+    framePrintf("    ");
     for (col = 0; col < COLS; col++) {
-        printf(" %d  ", col + 1);
+        framePrintf(" %d  ", col + 1);
     }
-    printf("\n");
+    framePrintf("\n");
     setColor(COLOR_DEFAULT);
     
     /* Top border */
     setColor(COLOR_BLUE);
-    printf("   +");
+    framePrintf("   +");
     for (col = 0; col < COLS; col++) {
-        printf("---+");
+        framePrintf("---+");
     }
-    printf("\n");
+    framePrintf("\n");
     
     /* Board cells */
     for (row = 0; row < ROWS; row++) {
         setColor(COLOR_BLUE);
-        printf("   |");
+        framePrintf("   |");
         
         for (col = 0; col < COLS; col++) {
             if (board[row][col] == EMPTY) {
-                printf("   ");
+                framePrintf("   ");
             } else if (board[row][col] == PLAYER1) {
                 setColor(COLOR_RED);
-                printf(" O ");
+                framePrintf(" O ");
             } else {
                 setColor(COLOR_YELLOW);
-                printf(" O ");
+                framePrintf(" O ");
             }
             setColor(COLOR_BLUE);
-            printf("|");
+            framePrintf("|");
         }
-        printf("\n");
+        framePrintf("\n");
         
         /* Row separator */
-        printf("   +");
+        framePrintf("   +");
         for (col = 0; col < COLS; col++) {
-            printf("---+");
+            framePrintf("---+");
         }
-        printf("\n");
+        framePrintf("\n");
     }
     
     setColor(COLOR_DEFAULT);
-    printf("\n");
+    framePrintf("\n");
 }
 
 /* Displays the main menu */
@@ -89,15 +116,15 @@ void displayMainMenu(void) {
     displayTitle();
     
     setColor(COLOR_GREEN);
-    printf("\n  Main Menu:\n");
+    framePrintf("\n  Main Menu:\n");
     setColor(COLOR_DEFAULT);
-    printf("  -----------------------\n");
-    printf("  1. Player vs Player\n");
-    printf("  2. Player vs Computer\n");
-    printf("  3. View Statistics\n");
-    printf("  4. Exit\n");
-    printf("  -----------------------\n");
-    printf("\n  Enter your choice (1-4): ");
+    framePrintf("  -----------------------\n");
+    framePrintf("  1. Player vs Player\n");
+    framePrintf("  2. Player vs Computer\n");
+    framePrintf("  3. View Statistics\n");
+    framePrintf("  4. Exit\n");
+    framePrintf("  -----------------------\n");
+    framePrintf("\n  Enter your choice (1-4): ");
 }
 
 /* Displays difficulty selection menu */
@@ -105,15 +132,17 @@ void displayDifficultyMenu(void) {
     displayTitle();
     
     setColor(COLOR_GREEN);
-    printf("\n  Select Difficulty:\n");
+    framePrintf("\n  Select Difficulty:\n");
     setColor(COLOR_DEFAULT);
-    printf("  -----------------------\n");
-    printf("  1. Easy   - Random moves\n");
-    printf("  2. Medium - Smart moves\n");
-    printf("  3. Hard   - Expert AI\n");
-    printf("  4. Back to Main Menu\n");
-    printf("  -----------------------\n");
-    printf("\n  Enter your choice (1-4): ");
+    framePrintf("  -----------------------\n");
+    framePrintf("  1. Easy   - Random moves\n");
+    framePrintf("  2. Medium - Smart moves\n");
+    framePrintf("  3. Hard   - Expert AI\n");
+    framePrintf("  4. Perfect - Solves the game\n");
+    framePrintf("  5. Monte Carlo - Tree search on random games\n");
+    framePrintf("  6. Back to Main Menu\n");
+    framePrintf("  -----------------------\n");
+    framePrintf("\n  Enter your choice (1-6): ");
 }
 
 /* Gets valid column input from user */
@@ -121,26 +150,19 @@ int getPlayerMove(int board[ROWS][COLS], int player) {
     int col;
     int valid = 0;
     int result;
-    int c;
     
     while (!valid) {
         if (player == PLAYER1) {
             setColor(COLOR_RED);
-            printf("  Player 1 (Red)");
+            framePrintf("  Player 1 (Red)");
         } else {
             setColor(COLOR_YELLOW);
-            printf("  Player 2 (Yellow)");
+            framePrintf("  Player 2 (Yellow)");
         }
         setColor(COLOR_DEFAULT);
-        printf(" - Enter column (1-7): ");
-        
-        /* Read number from user using scanf_s for Visual Studio */
-        result = scanf_s("%d", &col);
+        framePrintf(" - Enter column (1-7): ");
         
-        /* Clear remaining characters in input buffer */
-        while ((c = getchar()) != '\n' && c != EOF) {
-            /* Discard extra characters */
-        }
+        result = readNumber(&col);
         
         if (result == 1) {
             col--;  /* Convert to 0-indexed */
@@ -150,17 +172,17 @@ int getPlayerMove(int board[ROWS][COLS], int player) {
                     valid = 1;
                 } else {
                     setColor(COLOR_RED);
-                    printf("  Column is full! Try another.\n");
+                    framePrintf("  Column is full! Try another.\n");
                     setColor(COLOR_DEFAULT);
                 }
             } else {
                 setColor(COLOR_RED);
-                printf("  Invalid column! Enter 1-7.\n");
+                framePrintf("  Invalid column! Enter 1-7.\n");
                 setColor(COLOR_DEFAULT);
             }
         } else {
             setColor(COLOR_RED);
-            printf("  Invalid input! Enter a number 1-7.\n");
+            framePrintf("  Invalid input! Enter a number 1-7.\n");
             setColor(COLOR_DEFAULT);
         }
     }
@@ -170,47 +192,75 @@ int getPlayerMove(int board[ROWS][COLS], int player) {
 
 /* Displays win message */
 void displayWinMessage(int player) {
-    printf("\n");
+    framePrintf("\n");
     if (player == PLAYER1) {
         setColor(COLOR_RED);
-        printf("  *** PLAYER 1 (RED) WINS! ***\n");
+        framePrintf("  *** PLAYER 1 (RED) WINS! ***\n");
     } else {
         setColor(COLOR_YELLOW);
-        printf("  *** PLAYER 2 (YELLOW) WINS! ***\n");
+        framePrintf("  *** PLAYER 2 (YELLOW) WINS! ***\n");
+    }
+    setColor(COLOR_DEFAULT);
+    framePrintf("\n");
+}
+
+/* Displays the work behind the computer's last move */
+void displaySearchInfo(int col, const SearchInfo* info) {
+    setColor(COLOR_CYAN);
+    if (info->fromBook) {
+        framePrintf("  Last computer move: column %d from the opening book\n", col + 1);
+    } else if (info->playouts > 0) {
+        framePrintf("  Last computer move: column %d, %lld playouts, %.1f ms (%.0f playouts/s)\n",
+               col + 1, info->playouts, info->elapsedMicros / 1000.0,
+               info->elapsedMicros > 0 ? info->playouts * 1e6 / info->elapsedMicros : 0.0);
+        framePrintf("  Tree %lld nodes (%lld kept from the last move), depth %d\n",
+               info->nodes, info->reusedNodes, info->maxDepth);
+    } else {
+        /* A pondered move was searched before it was asked for */
+        framePrintf("  Last computer move: column %d, %lld nodes, %lld evaluations, %.1f ms\n",
+               col + 1, info->nodes, info->leafEvaluations,
+               (info->pondered ? info->ponderedMicros : info->elapsedMicros) / 1000.0);
+        framePrintf("  Depth %d (max %d), %lld cutoffs (%.0f%% on first move), TT %lld/%lld hits\n",
+               info->depth, info->maxDepth, info->cutoffs,
+               info->cutoffs > 0 ? 100.0 * info->firstMoveCutoffs / info->cutoffs : 0.0,
+               info->ttHits, info->ttProbes);
+    }
+    if (info->pondered) {
+        framePrintf("  Searched while you were thinking, answered in %.1f ms\n",
+               info->elapsedMicros / 1000.0);
+    } else if (info->ponderedMicros > 0) {
+        framePrintf("  Pondered %.1f ms before your move, then searched the rest\n",
+               info->ponderedMicros / 1000.0);
     }
     setColor(COLOR_DEFAULT);
-    printf("\n");
 }
 
 /* Displays tie message */
 void displayTieMessage(void) {
     setColor(COLOR_CYAN);
-    printf("\n  *** IT'S A TIE! ***\n\n");
+    framePrintf("\n  *** IT'S A TIE! ***\n\n");
     setColor(COLOR_DEFAULT);
 }
 
 /* Waits for user to press Enter */
 void waitForEnter(void) {
-    printf("  Press Enter to continue...");
-    while (getchar() != '\n') {
-        /* Wait for Enter key */
-    }
+    int c;
+    
+    framePrintf("  Press Enter to continue...");
+    flushFrame();
+    do {
+        c = getchar();
+    } while (c != '\n' && c != EOF);
+    frameInputEchoed();
 }
 
 /* Gets a valid menu choice from user */
 int getMenuChoice(int min, int max) {
     int choice;
     int result;
-    int c;
     
     while (1) {
-        /* Read number from user using scanf_s for Visual Studio */
-        result = scanf_s("%d", &choice);
-        
-        /* Clear remaining characters in input buffer */
-        while ((c = getchar()) != '\n' && c != EOF) {
-            /* Discard extra characters */
-        }
+        result = readNumber(&choice);
         
         if (result == 1) {
             if (choice >= min && choice <= max) {
@@ -219,7 +269,7 @@ int getMenuChoice(int min, int max) {
         }
         
         setColor(COLOR_RED);
-        printf("  Invalid choice! Enter %d-%d: ", min, max);
+        framePrintf("  Invalid choice! Enter %d-%d: ", min, max);
         setColor(COLOR_DEFAULT);
     }
 }
@@ -0,0 +1,438 @@
+/*
+ * bench.c - Micro-benchmarks of the board, win-check and search kernels
+ * Every kernel runs once to warm up, then a fixed number of timed
+ * repetitions; the median time per operation is the headline number.
+ * Reference positions come from a fixed pseudo-random sequence, so two
+ * runs of the same build measure exactly the same work.
+ *
+ * Usage: bench [text|csv|json] [repetitions]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../include/ai.h"
+#include "../include/board.h"
+#include "../include/game.h"
+#include "../include/bitboard.h"
+#include "../include/eval.h"
+#include "../include/mcts.h"
+#include "../include/search.h"
+#include "../include/transposition.h"
+#include "../include/timer.h"
+
+/* Default settings */
+#define DEFAULT_REPETITIONS 7
+#define MAX_REPETITIONS 101
+
+/* Number of reference positions and their move counts */
+#define REFERENCE_COUNT 16
+#define REFERENCE_MIN_PLIES 6
+#define REFERENCE_MAX_PLIES 30
+
+/* Depth of the fixed-depth search kernel */
+#define SEARCH_DEPTH 10
+
+/* Playouts of one Monte Carlo search */
+#define MCTS_PLAYOUTS 20000
+
+/* Output formats */
+#define FORMAT_TEXT 0
+#define FORMAT_CSV 1
+#define FORMAT_JSON 2
+
+/* A kernel runs its loop the given number of times and returns how
+ * many operations that was. Time spent on per-iteration setup that is
+ * not part of the measurement is added to setupMicros. */
+typedef long long (*KernelFunction)(long long iterations, long long* setupMicros);
+
+/* One benchmark */
+typedef struct {
+    const char* name;
+    const char* unit;          /* What one operation is */
+    KernelFunction run;
+    long long iterations;      /* Loop count of one repetition */
+} Kernel;
+
+/* Measured result of one benchmark */
+typedef struct {
+    long long operations;      /* Operations per repetition */
+    double medianNs;           /* Nanoseconds per operation */
+    double minNs;
+    double maxNs;
+} KernelResult;
+
+/* Reference positions in both representations */
+typedef struct {
+    int board[ROWS][COLS];
+    Position pos;
+    Evaluator eval;
+    int lastRow;               /* Last disc played */
+    int lastCol;
+    int lastPlayer;
+} ReferencePosition;
+
+static ReferencePosition g_references[REFERENCE_COUNT];
+
+/* Column orders replayed by the drop kernel (only valid moves are made) */
+static int g_sequences[REFERENCE_COUNT][BOARD_CELLS * 2];
+
+/* Results are summed into this so no kernel can be optimized away */
+static volatile long long g_sink = 0;
+
+/* Fixed linear congruential generator: the same numbers on every run */
+static unsigned int g_benchSeed = 12345;
+
+static int benchRandom(int limit) {
+    g_benchSeed = g_benchSeed * 1103515245u + 12345u;
+    return (int)((g_benchSeed >> 16) % (unsigned int)limit);
+}
+
+/* Plays random games and keeps positions with 6 to 30 discs that are
+ * still going on */
+static void buildReferences(void) {
+    ReferencePosition* ref;
+    int target;
+    int player;
+    int col, row;
+    int i, j;
+
+    for (i = 0; i < REFERENCE_COUNT; i++) {
+        ref = &g_references[i];
+        target = REFERENCE_MIN_PLIES +
+                 i * (REFERENCE_MAX_PLIES - REFERENCE_MIN_PLIES) / (REFERENCE_COUNT - 1);
+
+        /* Retry until a game reaches the target without a winner */
+        do {
+            initBoard(ref->board);
+            initPosition(&ref->pos);
+            player = PLAYER1;
+            for (j = 0; j < target; j++) {
+                do {
+                    col = benchRandom(COLS);
+                } while (!isValidMove(ref->board, col));
+                if (isWinningMove(&ref->pos, col)) {
+                    break;
+                }
+                row = dropDisc(ref->board, col, player);
+                playColumn(&ref->pos, col);
+                ref->lastRow = row;
+                ref->lastCol = col;
+                ref->lastPlayer = player;
+                player = (player == PLAYER1) ? PLAYER2 : PLAYER1;
+            }
+        } while (j < target);
+
+        initEvaluator(&ref->eval, &ref->pos);
+
+        for (j = 0; j < BOARD_CELLS * 2; j++) {
+            g_sequences[i][j] = benchRandom(COLS);
+        }
+    }
+}
+
+/* dropDisc + isValidMove: fills boards from the column sequences */
+static long long benchDropDisc(long long iterations, long long* setupMicros) {
+    int board[ROWS][COLS];
+    long long operations = 0;
+    long long sum = 0;
+    long long n;
+    int* sequence;
+    int player;
+    int j;
+
+    (void)setupMicros;  /* Nothing to exclude */
+    for (n = 0; n < iterations; n++) {
+        sequence = g_sequences[n % REFERENCE_COUNT];
+        initBoard(board);
+        player = PLAYER1;
+        for (j = 0; j < BOARD_CELLS * 2; j++) {
+            if (isValidMove(board, sequence[j])) {
+                sum += dropDisc(board, sequence[j], player);
+                player = (player == PLAYER1) ? PLAYER2 : PLAYER1;
+            }
+            operations++;
+        }
+    }
+    g_sink += sum;
+    return operations;
+}
+
+/* checkWin on the reference boards */
+static long long benchCheckWin(long long iterations, long long* setupMicros) {
+    long long sum = 0;
+    long long n;
+
+    (void)setupMicros;  /* Nothing to exclude */
+    for (n = 0; n < iterations; n++) {
+        ReferencePosition* ref = &g_references[n % REFERENCE_COUNT];
+        sum += checkWin(ref->board, ref->lastPlayer);
+    }
+    g_sink += sum;
+    return iterations;
+}
+
+/* getGameState on the reference boards */
+static long long benchGameState(long long iterations, long long* setupMicros) {
+    long long sum = 0;
+    long long n;
+
+    (void)setupMicros;  /* Nothing to exclude */
+    for (n = 0; n < iterations; n++) {
+        ReferencePosition* ref = &g_references[n % REFERENCE_COUNT];
+        sum += getGameState(ref->board, ref->lastPlayer);
+    }
+    g_sink += sum;
+    return iterations;
+}
+
+/* checkWinAt through the last disc of the reference boards */
+static long long benchCheckWinAt(long long iterations, long long* setupMicros) {
+    long long sum = 0;
+    long long n;
+
+    (void)setupMicros;  /* Nothing to exclude */
+    for (n = 0; n < iterations; n++) {
+        ReferencePosition* ref = &g_references[n % REFERENCE_COUNT];
+        sum += checkWinAt(ref->board, ref->lastRow, ref->lastCol, ref->lastPlayer);
+    }
+    g_sink += sum;
+    return iterations;
+}
+
+/* calculatePositionScore for every playable column */
+static long long benchPositionScore(long long iterations, long long* setupMicros) {
+    long long operations = 0;
+    long long sum = 0;
+    long long n;
+    int row, col;
+
+    (void)setupMicros;  /* Nothing to exclude */
+    for (n = 0; n < iterations; n++) {
+        ReferencePosition* ref = &g_references[n % REFERENCE_COUNT];
+        for (col = 0; col < COLS; col++) {
+            row = ROWS - 1 - ref->pos.height[col];
+            if (row >= 0) {
+                sum += calculatePositionScore(ref->board, row, col, PLAYER2);
+                operations++;
+            }
+        }
+    }
+    g_sink += sum;
+    return operations;
+}
+
+/* getMediumMove for the side to move on the reference boards */
+static long long benchMediumMove(long long iterations, long long* setupMicros) {
+    long long sum = 0;
+    long long n;
+    int player;
+
+    (void)setupMicros;  /* Nothing to exclude */
+    for (n = 0; n < iterations; n++) {
+        ReferencePosition* ref = &g_references[n % REFERENCE_COUNT];
+        player = (ref->pos.moves & 1) ? PLAYER2 : PLAYER1;
+        sum += getMediumMove(ref->board, player);
+    }
+    g_sink += sum;
+    return iterations;
+}
+
+/* evaluateBoardState on the reference positions (leaf evaluation) */
+static long long benchEvaluate(long long iterations, long long* setupMicros) {
+    long long sum = 0;
+    long long n;
+
+    (void)setupMicros;  /* Nothing to exclude */
+    for (n = 0; n < iterations; n++) {
+        ReferencePosition* ref = &g_references[n % REFERENCE_COUNT];
+        sum += evaluateBoardState(&ref->eval, &ref->pos);
+    }
+    g_sink += sum;
+    return iterations;
+}
+
+/* minimaxAlgorithm nodes: fixed-depth searches from a cold table */
+static long long benchSearch(long long iterations, long long* setupMicros) {
+    SearchLimits limits;
+    SearchResult result;
+    long long nodes = 0;
+    long long start;
+    long long n;
+
+    limits.maxDepth = SEARCH_DEPTH;
+    limits.timeLimitMs = 0;
+    limits.nodeLimit = 0;
+    limits.threads = 1;
+    limits.stop = NULL;
+
+    for (n = 0; n < iterations; n++) {
+        /* Cold table for every search, clearing it is not measured */
+        start = getTimeMicros();
+        clearTranspositionTable();
+        *setupMicros += getTimeMicros() - start;
+        searchPosition(&g_references[n % REFERENCE_COUNT].pos, &limits, &result);
+        nodes += result.nodes;
+        g_sink += result.bestMove;
+    }
+    return nodes;
+}
+
+/* Monte Carlo playouts: fixed-size searches from a fresh tree */
+static long long benchMcts(long long iterations, long long* setupMicros) {
+    static MctsTree tree;
+    MctsLimits limits;
+    MctsResult result;
+    long long playouts = 0;
+    long long start;
+    long long n;
+
+    limits.playoutLimit = MCTS_PLAYOUTS;
+    limits.timeLimitMs = 0;
+    limits.threads = 1;
+    limits.stop = NULL;
+
+    for (n = 0; n < iterations; n++) {
+        /* Allocating the pools and forgetting the tree is not measured */
+        start = getTimeMicros();
+        if (tree.nodes == NULL && !initMctsTree(&tree, MCTS_DEFAULT_POOL_NODES)) {
+            return 0;
+        }
+        clearMctsTree(&tree);
+        seedMctsTree(&tree, (unsigned long long)n + 1);
+        *setupMicros += getTimeMicros() - start;
+        searchMcts(&tree, &g_references[n % REFERENCE_COUNT].pos, &limits, &result);
+        playouts += result.playouts;
+        g_sink += result.bestMove;
+    }
+    return playouts;
+}
+
+/* All benchmarks, in report order */
+static const Kernel g_kernels[] = {
+    {"dropDisc+isValidMove", "move", benchDropDisc, 20000},
+    {"checkWin", "call", benchCheckWin, 1000000},
+    {"getGameState", "call", benchGameState, 1000000},
+    {"checkWinAt", "call", benchCheckWinAt, 4000000},
+    {"calculatePositionScore", "call", benchPositionScore, 200000},
+    {"getMediumMove", "move", benchMediumMove, 200000},
+    {"evaluateBoardState", "call", benchEvaluate, 4000000},
+    {"minimaxAlgorithm", "node", benchSearch, 4 * REFERENCE_COUNT},
+    {"searchMcts", "playout", benchMcts, REFERENCE_COUNT}
+};
+
+#define KERNEL_COUNT ((int)(sizeof(g_kernels) / sizeof(g_kernels[0])))
+
+/* qsort comparison of doubles */
+static int compareDoubles(const void* a, const void* b) {
+    double x = *(const double*)a;
+    double y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+/* Warms up and times one kernel */
+static void runKernel(const Kernel* kernel, int repetitions, KernelResult* result) {
+    double times[MAX_REPETITIONS];
+    long long start;
+    long long setup = 0;
+    long long operations = 1;
+    int i;
+
+    kernel->run(kernel->iterations, &setup);  /* Warm-up: caches, tables, branch predictors */
+
+    for (i = 0; i < repetitions; i++) {
+        setup = 0;
+        start = getTimeMicros();
+        operations = kernel->run(kernel->iterations, &setup);
+        if (operations < 1) {
+            operations = 1;
+        }
+        times[i] = (double)(getTimeMicros() - start - setup) * 1000.0 / (double)operations;
+    }
+
+    qsort(times, (size_t)repetitions, sizeof(double), compareDoubles);
+    result->operations = operations;
+    result->medianNs = times[repetitions / 2];
+    result->minNs = times[0];
+    result->maxNs = times[repetitions - 1];
+}
+
+/* Operations per second for a time per operation */
+static double perSecond(double ns) {
+    return ns > 0.0 ? 1e9 / ns : 0.0;
+}
+
+/* Prints one result in the chosen format */
+static void printResult(int format, const Kernel* kernel, const KernelResult* result,
+                        int repetitions, int last) {
+    switch (format) {
+        case FORMAT_CSV:
+            printf("%s,%s,%lld,%d,%.3f,%.3f,%.3f,%.0f\n", kernel->name, kernel->unit,
+                   result->operations, repetitions, result->medianNs, result->minNs,
+                   result->maxNs, perSecond(result->medianNs));
+            break;
+        case FORMAT_JSON:
+            printf("    {\"name\": \"%s\", \"unit\": \"%s\", \"operations\": %lld, "
+                   "\"repetitions\": %d, \"median_ns\": %.3f, \"min_ns\": %.3f, "
+                   "\"max_ns\": %.3f, \"per_second\": %.0f}%s\n",
+                   kernel->name, kernel->unit, result->operations, repetitions,
+                   result->medianNs, result->minNs, result->maxNs,
+                   perSecond(result->medianNs), last ? "" : ",");
+            break;
+        default:
+            printf("  %-24s %10.2f ns/%-5s %14.0f /s   (min %.2f, max %.2f)\n",
+                   kernel->name, result->medianNs, kernel->unit,
+                   perSecond(result->medianNs), result->minNs, result->maxNs);
+            break;
+    }
+}
+
+/* Program entry point */
+int main(int argc, char* argv[]) {
+    KernelResult result;
+    int format = FORMAT_TEXT;
+    int repetitions = DEFAULT_REPETITIONS;
+    int i;
+
+    if (argc > 1) {
+        if (strcmp(argv[1], "csv") == 0) {
+            format = FORMAT_CSV;
+        } else if (strcmp(argv[1], "json") == 0) {
+            format = FORMAT_JSON;
+        } else if (strcmp(argv[1], "text") != 0) {
+            fprintf(stderr, "format must be text, csv or json\n");
+            return 1;
+        }
+    }
+    if (argc > 2) {
+        repetitions = atoi(argv[2]);
+    }
+    if (repetitions < 1 || repetitions > MAX_REPETITIONS) {
+        fprintf(stderr, "repetitions must be between 1 and %d\n", MAX_REPETITIONS);
+        return 1;
+    }
+
+    initTranspositionTable(TT_DEFAULT_SIZE_MB);
+    buildReferences();
+
+    if (format == FORMAT_CSV) {
+        printf("name,unit,operations,repetitions,median_ns,min_ns,max_ns,per_second\n");
+    } else if (format == FORMAT_JSON) {
+        printf("{\n  \"search_depth\": %d,\n  \"results\": [\n", SEARCH_DEPTH);
+    } else {
+        printf("Benchmarks: %d repetitions after a warm-up, median time per operation\n",
+               repetitions);
+    }
+
+    for (i = 0; i < KERNEL_COUNT; i++) {
+        runKernel(&g_kernels[i], repetitions, &result);
+        printResult(format, &g_kernels[i], &result, repetitions, i == KERNEL_COUNT - 1);
+    }
+
+    if (format == FORMAT_JSON) {
+        printf("  ]\n}\n");
+    }
+
+    freeTranspositionTable();
+    return 0;
+}
@@ -0,0 +1,171 @@
+/*
+ * bookgen.c - Opening book generator
+ * Enumerates every position with up to N discs, drops mirror images,
+ * searches each one and writes the sorted book file used by book.c.
+ *
+ * Usage: bookgen [plies] [depth] [output file]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../include/book.h"
+#include "../include/search.h"
+#include "../include/transposition.h"
+
+/* Default settings */
+#define DEFAULT_PLIES 6
+#define DEFAULT_DEPTH 14
+
+/* A distinct position found by the enumeration */
+typedef struct {
+    uint64_t key;                 /* Canonical key */
+    char moves[BOARD_CELLS + 1];  /* Move string (columns '0'-'6') reaching it */
+} BookPosition;
+
+/* Growing list of enumerated positions */
+static BookPosition* g_positions = NULL;
+static size_t g_count = 0;
+static size_t g_capacity = 0;
+
+/* Adds a position to the list */
+static void addPosition(uint64_t key, const char* moves) {
+    if (g_count == g_capacity) {
+        g_capacity = g_capacity ? g_capacity * 2 : 4096;
+        g_positions = (BookPosition*)realloc(g_positions, g_capacity * sizeof(BookPosition));
+        if (g_positions == NULL) {
+            fprintf(stderr, "Out of memory\n");
+            exit(1);
+        }
+    }
+    g_positions[g_count].key = key;
+    strcpy(g_positions[g_count].moves, moves);
+    g_count++;
+}
+
+/* Depth-first enumeration of all non-finished positions up to maxPlies */
+static void enumerate(Position* pos, char* moves, int maxPlies) {
+    int mirrored;
+    int col;
+
+    addPosition(canonicalBookKey(pos, &mirrored), moves);
+    if (pos->moves == maxPlies) {
+        return;
+    }
+
+    for (col = 0; col < COLS; col++) {
+        if (canPlayColumn(pos, col) && !isWinningMove(pos, col)) {
+            moves[pos->moves] = (char)('0' + col);
+            moves[pos->moves + 1] = '\0';
+            playColumn(pos, col);
+            enumerate(pos, moves, maxPlies);
+            undoColumn(pos, col);
+            moves[pos->moves] = '\0';
+        }
+    }
+}
+
+/* qsort comparison by key */
+static int compareKeys(const void* a, const void* b) {
+    uint64_t keyA = ((const BookPosition*)a)->key;
+    uint64_t keyB = ((const BookPosition*)b)->key;
+    return (keyA > keyB) - (keyA < keyB);
+}
+
+/* Program entry point */
+int main(int argc, char* argv[]) {
+    int plies = DEFAULT_PLIES;
+    int depth = DEFAULT_DEPTH;
+    const char* output = BOOK_FILE;
+    char moves[BOARD_CELLS + 1] = "";
+    Position pos;
+    SearchLimits limits;
+    SearchResult result;
+    BookHeader header;
+    uint64_t* entries;
+    size_t unique = 0;
+    size_t i, j;
+    int mirrored;
+    int move;
+    FILE* file;
+
+    if (argc > 1) {
+        plies = atoi(argv[1]);
+    }
+    if (argc > 2) {
+        depth = atoi(argv[2]);
+    }
+    if (argc > 3) {
+        output = argv[3];
+    }
+    if (plies < 0 || plies >= BOARD_CELLS) {
+        fprintf(stderr, "plies must be between 0 and %d\n", BOARD_CELLS - 1);
+        return 1;
+    }
+
+    /* Enumerate, then sort and drop duplicates (transpositions and mirrors) */
+    initPosition(&pos);
+    enumerate(&pos, moves, plies);
+    qsort(g_positions, g_count, sizeof(BookPosition), compareKeys);
+    for (i = 0; i < g_count; i++) {
+        if (unique == 0 || g_positions[i].key != g_positions[unique - 1].key) {
+            g_positions[unique++] = g_positions[i];
+        }
+    }
+    printf("%lu positions with up to %d discs (%lu before deduplication)\n",
+           (unsigned long)unique, plies, (unsigned long)g_count);
+
+    entries = (uint64_t*)malloc((unique ? unique : 1) * sizeof(uint64_t));
+    if (entries == NULL) {
+        fprintf(stderr, "Out of memory\n");
+        return 1;
+    }
+
+    limits.maxDepth = depth;
+    limits.timeLimitMs = 0;
+    limits.nodeLimit = 0;
+    limits.threads = 1;
+    limits.stop = NULL;
+    initTranspositionTable(64);
+
+    /* Search every position; entries stay sorted because keys are */
+    for (i = 0; i < unique; i++) {
+        initPosition(&pos);
+        for (j = 0; g_positions[i].moves[j] != '\0'; j++) {
+            playColumn(&pos, g_positions[i].moves[j] - '0');
+        }
+        move = searchPosition(&pos, &limits, &result);
+        canonicalBookKey(&pos, &mirrored);
+        if (mirrored) {
+            move = COLS - 1 - move;  /* Store the move of the canonical side */
+        }
+        entries[i] = BOOK_ENTRY(g_positions[i].key, move);
+
+        if ((i + 1) % 1000 == 0 || i + 1 == unique) {
+            printf("  %lu / %lu\r", (unsigned long)(i + 1), (unsigned long)unique);
+            fflush(stdout);
+        }
+    }
+    printf("\n");
+
+    header.magic = BOOK_MAGIC;
+    header.version = BOOK_VERSION;
+    header.plies = (uint32_t)plies;
+    header.count = (uint32_t)unique;
+
+    file = fopen(output, "wb");
+    if (file == NULL) {
+        fprintf(stderr, "Can not write %s\n", output);
+        return 1;
+    }
+    fwrite(&header, sizeof(header), 1, file);
+    fwrite(entries, sizeof(uint64_t), unique, file);
+    fclose(file);
+    printf("Wrote %s (%lu bytes)\n", output,
+           (unsigned long)(sizeof(header) + unique * sizeof(uint64_t)));
+
+    free(entries);
+    free(g_positions);
+    freeTranspositionTable();
+    return 0;
+}
@@ -0,0 +1,14 @@
+/*
+ * engine.c - Text protocol engine
+ * Reads commands from stdin and answers on stdout (see protocol.h), so
+ * a supervisor can pipe any number of positions through one process.
+ *
+ * Usage: engine < commands.txt
+ */
+
+#include "../include/protocol.h"
+
+/* Program entry point */
+int main(void) {
+    return runEngineProtocol(stdin, stdout);
+}
@@ -0,0 +1,150 @@
+/*
+ * kplay.c - Connect-K self-play on any board size
+ * Plays fixed-depth games of the Connect-K engine against itself on a
+ * configurable board (e.g. 9x7 connect-4 or 15x15 connect-5) and reports
+ * the results and search speed. Every game starts with a few random
+ * moves so the games differ. After every move the win found by the line
+ * counters is checked against the multi-word bitboard kernel
+ * (connectKHasAlignment); any disagreement fails the run.
+ *
+ * Usage: kplay [width] [height] [k] [games] [depth] [seed]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "../include/connectk.h"
+#include "../include/game.h"
+#include "../include/eval.h"
+#include "../include/transposition.h"
+#include "../include/timer.h"
+
+/* Default settings */
+#define DEFAULT_WIDTH 9
+#define DEFAULT_HEIGHT 7
+#define DEFAULT_K 4
+#define DEFAULT_GAMES 10
+#define DEFAULT_DEPTH 6
+#define DEFAULT_SEED 1
+
+/* Random moves at the start of every game */
+#define OPENING_PLIES 2
+
+/* Random playable column */
+static int randomColumn(const ConnectKGame* game) {
+    int col;
+    do {
+        col = rand() % game->rules->width;
+    } while (!connectKCanPlay(game, col));
+    return col;
+}
+
+/* Program entry point */
+int main(int argc, char* argv[]) {
+    static ConnectKRules rules;
+    static ConnectKGame game;
+    long long results[3] = {0};    /* First mover wins, draws, second mover wins */
+    long long nodes = 0;
+    long long moveNodes;
+    long long searchMicros = 0;
+    long long start;
+    long long plies = 0;
+    long long mismatches = 0;
+    int width = DEFAULT_WIDTH;
+    int height = DEFAULT_HEIGHT;
+    int k = DEFAULT_K;
+    int games = DEFAULT_GAMES;
+    int depth = DEFAULT_DEPTH;
+    unsigned int seed = DEFAULT_SEED;
+    int state;
+    int mover;
+    int score;
+    int col;
+    int i;
+
+    if (argc > 1) {
+        width = atoi(argv[1]);
+    }
+    if (argc > 2) {
+        height = atoi(argv[2]);
+    }
+    if (argc > 3) {
+        k = atoi(argv[3]);
+    }
+    if (argc > 4) {
+        games = atoi(argv[4]);
+    }
+    if (argc > 5) {
+        depth = atoi(argv[5]);
+    }
+    if (argc > 6) {
+        seed = (unsigned int)strtoul(argv[6], NULL, 10);
+    }
+    if (!initConnectKRules(&rules, width, height, k)) {
+        fprintf(stderr, "unsupported board %dx%d with K = %d (sizes %d-%d, K %d-%d)\n",
+                width, height, k, KBOARD_MIN_SIZE, KBOARD_MAX_WIDTH, KBOARD_MIN_K, KBOARD_MAX_K);
+        return 1;
+    }
+    if (depth < 1) {
+        fprintf(stderr, "depth must be at least 1\n");
+        return 1;
+    }
+
+    /* The 7x6 fast path runs the Hard AI search and needs its tables */
+    if (rules.fastPath) {
+        initTranspositionTable(TT_DEFAULT_SIZE_MB);
+        initEvaluationTables();
+    }
+
+    srand(seed);
+    printf("Connect-%d on %dx%d: %d lines, %d bitboard words%s, %d games at depth %d\n",
+           k, width, height, rules.lineCount, rules.words,
+           rules.fastPath ? " (7x6 fast path)" : "", games, depth);
+
+    for (i = 0; i < games; i++) {
+        initConnectKGame(&game, &rules);
+        state = GAME_ONGOING;
+        while (state == GAME_ONGOING) {
+            if (game.moves < OPENING_PLIES) {
+                col = randomColumn(&game);
+            } else {
+                start = getTimeMicros();
+                col = searchConnectK(&game, depth, &score, &moveNodes);
+                searchMicros += getTimeMicros() - start;
+                nodes += moveNodes;
+            }
+            mover = game.moves & 1;
+            state = connectKPlay(&game, col);
+            plies++;
+
+            /* Only the mover can have K in a row, and only if it just won */
+            if (connectKHasAlignment(&game, mover) != (state == GAME_WIN) ||
+                connectKHasAlignment(&game, mover ^ 1)) {
+                mismatches++;
+            }
+        }
+
+        if (state == GAME_TIE) {
+            results[1]++;
+        } else if (game.moves & 1) {
+            results[0]++;
+        } else {
+            results[2]++;
+        }
+    }
+
+    if (searchMicros < 1) {
+        searchMicros = 1;
+    }
+    printf("First mover wins %lld, draws %lld, second mover wins %lld\n",
+           results[0], results[1], results[2]);
+    printf("Plies per game %.1f, nodes %lld, search time %.2f s, %.0f nodes/sec\n",
+           games > 0 ? (double)plies / games : 0.0, nodes, (double)searchMicros / 1e6,
+           (double)nodes * 1e6 / (double)searchMicros);
+    printf("Win check: line counters and bitboard kernel %s on %lld moves\n",
+           mismatches == 0 ? "agree" : "DISAGREE", plies);
+
+    if (rules.fastPath) {
+        freeTranspositionTable();
+    }
+    return mismatches == 0 ? 0 : 1;
+}
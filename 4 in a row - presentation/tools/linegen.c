@@ -0,0 +1,216 @@
+/*
+ * linegen.c - Winning line table generator
+ * Enumerates every line of four cells on the ROWS x COLS board, the
+ * lines through each cell and the rays from each cell to the edges,
+ * and writes them as the C source src/linetables.c. Run by make before
+ * the library is built; it links against nothing else.
+ *
+ * Usage: linegen <output file>
+ */
+
+#include <stdio.h>
+#include "../include/lines.h"
+
+/* Line directions as board steps (row 0 is the top row) */
+static const int g_directions[4][2] = {
+    {0, 1},     /* Horizontal */
+    {1, 0},     /* Vertical (down) */
+    {1, 1},     /* Diagonal (down-right) */
+    {-1, 1}     /* Anti-diagonal (up-right) */
+};
+
+/* First line of each direction as lines.h expects it */
+static const int g_firstLines[4] = {
+    FIRST_HORIZONTAL_LINE, FIRST_VERTICAL_LINE, FIRST_DIAGONAL_LINE, FIRST_ANTIDIAGONAL_LINE
+};
+
+/* Tables being built */
+static int g_lineCount = 0;
+static unsigned char g_lines[LINE_COUNT][4];           /* Cells */
+static unsigned char g_lineIndexes[LINE_COUNT][4];     /* Board indexes */
+static unsigned char g_cellLinesOut[BOARD_CELLS][MAX_CELL_LINES];
+static unsigned char g_cellLineCountOut[BOARD_CELLS];
+static unsigned char g_rays[BOARD_CELLS][DIRECTION_SLOTS][MAX_RAY_LENGTH];
+static unsigned char g_rayLengths[BOARD_CELLS][DIRECTION_SLOTS];
+
+/* Returns 1 if (row, col) is on the board */
+static int onBoard(int row, int col) {
+    return row >= 0 && row < ROWS && col >= 0 && col < COLS;
+}
+
+/* Adds every line of one direction, returns 0 if a table is too small */
+static int addLines(int rowDir, int colDir) {
+    int row, col;
+    int cell;
+    int i;
+
+    for (row = 0; row < ROWS; row++) {
+        for (col = 0; col < COLS; col++) {
+            if (!onBoard(row + 3 * rowDir, col + 3 * colDir)) {
+                continue;
+            }
+            if (g_lineCount == LINE_COUNT) {
+                return 0;
+            }
+            for (i = 0; i < 4; i++) {
+                cell = BOARD_CELL(row + i * rowDir, col + i * colDir);
+                if (g_cellLineCountOut[cell] == MAX_CELL_LINES) {
+                    return 0;
+                }
+                g_lines[g_lineCount][i] = (unsigned char)cell;
+                g_lineIndexes[g_lineCount][i] =
+                    (unsigned char)BOARD_INDEX(row + i * rowDir, col + i * colDir);
+                g_cellLinesOut[cell][g_cellLineCountOut[cell]++] = (unsigned char)g_lineCount;
+            }
+            g_lineCount++;
+        }
+    }
+    return 1;
+}
+
+/* Fills the rays of every board index in all eight directions */
+static void addRays(void) {
+    int row, col;
+    int rowDir, colDir;
+    int slot;
+    int r, c;
+
+    for (row = 0; row < ROWS; row++) {
+        for (col = 0; col < COLS; col++) {
+            for (rowDir = -1; rowDir <= 1; rowDir++) {
+                for (colDir = -1; colDir <= 1; colDir++) {
+                    if (rowDir == 0 && colDir == 0) {
+                        continue;
+                    }
+                    slot = DIRECTION_INDEX(rowDir, colDir);
+                    for (r = row + rowDir, c = col + colDir; onBoard(r, c); r += rowDir, c += colDir) {
+                        g_rays[BOARD_INDEX(row, col)][slot][g_rayLengths[BOARD_INDEX(row, col)][slot]++] =
+                            (unsigned char)BOARD_INDEX(r, c);
+                    }
+                }
+            }
+        }
+    }
+}
+
+/* Writes rows of numbers as a C initializer body, perLine per line */
+static void writeNumbers(FILE* out, const unsigned char* numbers, int count, int perLine) {
+    int i;
+
+    for (i = 0; i < count; i++) {
+        fprintf(out, "%s%d%s", i % perLine == 0 ? "    " : " ", numbers[i],
+                i == count - 1 ? "\n" : (i % perLine == perLine - 1 ? ",\n" : ","));
+    }
+}
+
+/* Writes a two-dimensional table, one row per source line */
+static void writeTable2(FILE* out, const char* declaration, const unsigned char* numbers,
+                        int rows, int width) {
+    int row;
+    int i;
+
+    fprintf(out, "%s = {\n", declaration);
+    for (row = 0; row < rows; row++) {
+        fprintf(out, "    {");
+        for (i = 0; i < width; i++) {
+            fprintf(out, "%s%d", i > 0 ? ", " : "", numbers[row * width + i]);
+        }
+        fprintf(out, "}%s\n", row == rows - 1 ? "" : ",");
+    }
+    fprintf(out, "};\n");
+}
+
+/* Writes the ray table, one cell per block */
+static void writeRays(FILE* out) {
+    int index;
+    int slot;
+    int i;
+
+    fprintf(out, "\n/* Board indexes along each direction, nearest first */\n");
+    fprintf(out, "const unsigned char g_boardRays[BOARD_CELLS][DIRECTION_SLOTS][MAX_RAY_LENGTH] = {\n");
+    for (index = 0; index < BOARD_CELLS; index++) {
+        fprintf(out, "    {");
+        for (slot = 0; slot < DIRECTION_SLOTS; slot++) {
+            fprintf(out, "%s{", slot > 0 ? ", " : "");
+            for (i = 0; i < MAX_RAY_LENGTH; i++) {
+                fprintf(out, "%s%d", i > 0 ? "," : "", g_rays[index][slot][i]);
+            }
+            fprintf(out, "}");
+        }
+        fprintf(out, "}%s\n", index == BOARD_CELLS - 1 ? "" : ",");
+    }
+    fprintf(out, "};\n");
+}
+
+/* Program entry point */
+int main(int argc, char* argv[]) {
+    FILE* out;
+    int maxLines = 0;
+    int cell;
+    int i;
+
+    if (argc < 2) {
+        fprintf(stderr, "usage: linegen <output file>\n");
+        return 1;
+    }
+
+    for (i = 0; i < 4; i++) {
+        if (g_lineCount != g_firstLines[i]) {
+            fprintf(stderr, "linegen: direction %d starts at line %d, lines.h says %d\n",
+                    i, g_lineCount, g_firstLines[i]);
+            return 1;
+        }
+        if (!addLines(g_directions[i][0], g_directions[i][1])) {
+            fprintf(stderr, "linegen: LINE_COUNT or MAX_CELL_LINES in lines.h is too small\n");
+            return 1;
+        }
+    }
+    if (g_lineCount != LINE_COUNT) {
+        fprintf(stderr, "linegen: %d lines, lines.h says %d\n", g_lineCount, LINE_COUNT);
+        return 1;
+    }
+    for (cell = 0; cell < BOARD_CELLS; cell++) {
+        if (g_cellLineCountOut[cell] > maxLines) {
+            maxLines = g_cellLineCountOut[cell];
+        }
+    }
+    if (maxLines != MAX_CELL_LINES) {
+        fprintf(stderr, "linegen: at most %d lines per cell, lines.h says %d\n",
+                maxLines, MAX_CELL_LINES);
+        return 1;
+    }
+    addRays();
+
+    out = fopen(argv[1], "w");
+    if (out == NULL) {
+        fprintf(stderr, "linegen: can not write %s\n", argv[1]);
+        return 1;
+    }
+
+    fprintf(out, "/*\n"
+                 " * linetables.c - Winning line tables\n"
+                 " * Generated by tools/linegen.c for a %d x %d board, do not edit\n"
+                 " */\n\n"
+                 "#include \"../include/lines.h\"\n\n", COLS, ROWS);
+
+    fprintf(out, "/* Board indexes of each line */\n");
+    writeTable2(out, "const unsigned char g_lineBoardIndex[LINE_COUNT][4]", &g_lineIndexes[0][0],
+                LINE_COUNT, 4);
+    fprintf(out, "\n/* Lines through each cell */\n");
+    writeTable2(out, "const unsigned char g_cellLines[BOARD_CELLS][MAX_CELL_LINES]",
+                &g_cellLinesOut[0][0], BOARD_CELLS, MAX_CELL_LINES);
+    fprintf(out, "\n/* Number of lines through each cell */\n");
+    fprintf(out, "const unsigned char g_cellLineCount[BOARD_CELLS] = {\n");
+    writeNumbers(out, g_cellLineCountOut, BOARD_CELLS, ROWS);
+    fprintf(out, "};\n");
+    writeRays(out);
+    fprintf(out, "\n/* Cells in each ray */\n");
+    writeTable2(out, "const unsigned char g_boardRayLength[BOARD_CELLS][DIRECTION_SLOTS]",
+                &g_rayLengths[0][0], BOARD_CELLS, DIRECTION_SLOTS);
+
+    if (fclose(out) != 0) {
+        fprintf(stderr, "linegen: can not write %s\n", argv[1]);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,135 @@
+/*
+ * mctsbench.c - Multi-threaded Monte Carlo scaling benchmark
+ * Searches reference positions for a fixed time with 1, 2, 4 ... up to
+ * N threads sharing one tree and reports playouts per second, the
+ * speedup over one thread and the efficiency per thread.
+ *
+ * Usage: mctsbench [threads] [milliseconds per position]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "../include/mcts.h"
+
+/* Reference positions as move strings (columns 1-7) */
+static const char* g_positions[] = {
+    "",
+    "4",
+    "44",
+    "4444",
+    "444443",
+    "4453345",
+    "3454",
+    "43442"
+};
+
+#define POSITION_COUNT ((int)(sizeof(g_positions) / sizeof(g_positions[0])))
+
+/* Builds a position from a move string, returns 0 on an illegal move */
+static int setupPosition(Position* pos, const char* moves) {
+    int col;
+
+    initPosition(pos);
+    for (; *moves != '\0'; moves++) {
+        col = *moves - '1';
+        if (!canPlayColumn(pos, col) || isWinningMove(pos, col)) {
+            return 0;
+        }
+        playColumn(pos, col);
+    }
+    return 1;
+}
+
+/* Searches every reference position from a fresh tree, returns the
+ * playouts per second over all of them */
+static double runAll(MctsTree* tree, int threads, long milliseconds) {
+    MctsLimits limits;
+    MctsResult result;
+    Position pos;
+    long long playouts = 0;
+    long long micros = 0;
+    int i;
+
+    limits.playoutLimit = 0;
+    limits.timeLimitMs = milliseconds;
+    limits.threads = threads;
+    limits.stop = NULL;
+
+    for (i = 0; i < POSITION_COUNT; i++) {
+        if (!setupPosition(&pos, g_positions[i])) {
+            continue;
+        }
+        clearMctsTree(tree);  /* Same cold start for every run */
+        seedMctsTree(tree, (unsigned long long)i + 1);
+        searchMcts(tree, &pos, &limits, &result);
+        playouts += result.playouts;
+        micros += result.elapsedMicros;
+        printf("  %-16s threads=%-2d move=%d win=%.3f playouts=%lld nodes=%d depth=%d%s\n",
+               g_positions[i][0] ? g_positions[i] : "(empty)",
+               result.threads, result.bestMove + 1, result.winRate, result.playouts,
+               result.treeNodes, result.maxDepth, result.poolFull ? " (pool full)" : "");
+    }
+    return micros > 0 ? (double)playouts * 1e6 / (double)micros : 0.0;
+}
+
+/* Program entry point */
+int main(int argc, char* argv[]) {
+    static MctsTree tree;
+    MctsLimits limits;
+    MctsResult result;
+    Position pos;
+    double rates[MCTS_MAX_THREADS + 1];
+    int counts[MCTS_MAX_THREADS + 1];
+    int runs = 0;
+    int threads = 4;
+    long milliseconds = 1000;
+    int n;
+    int i;
+
+    if (argc > 1) {
+        threads = atoi(argv[1]);
+    }
+    if (argc > 2) {
+        milliseconds = atol(argv[2]);
+    }
+    if (threads < 1 || threads > MCTS_MAX_THREADS || milliseconds < 1) {
+        fprintf(stderr, "usage: mctsbench [threads 1-%d] [milliseconds]\n", MCTS_MAX_THREADS);
+        return 1;
+    }
+    if (!initMctsTree(&tree, MCTS_DEFAULT_POOL_NODES)) {
+        fprintf(stderr, "mctsbench: out of memory\n");
+        return 1;
+    }
+
+    /* Warm-up: the first search also pays for faulting in the pools */
+    initPosition(&pos);
+    limits.playoutLimit = 0;
+    limits.timeLimitMs = milliseconds;
+    limits.threads = 1;
+    limits.stop = NULL;
+    searchMcts(&tree, &pos, &limits, &result);
+
+    /* Powers of two, then the requested count itself */
+    for (n = 1; ; n *= 2) {
+        if (n > threads) {
+            n = threads;
+        }
+        printf("%d thread%s, %ld ms per position:\n", n, n == 1 ? "" : "s", milliseconds);
+        counts[runs] = n;
+        rates[runs] = runAll(&tree, n, milliseconds);
+        runs++;
+        if (n == threads) {
+            break;
+        }
+    }
+
+    printf("\nThreads  Playouts/s  Speedup  Efficiency\n");
+    for (i = 0; i < runs; i++) {
+        printf("%7d  %10.0f  %6.2fx  %9.0f%%\n", counts[i], rates[i],
+               rates[0] > 0 ? rates[i] / rates[0] : 0.0,
+               rates[0] > 0 ? 100.0 * rates[i] / (rates[0] * counts[i]) : 0.0);
+    }
+
+    freeMctsTree(&tree);
+    return 0;
+}
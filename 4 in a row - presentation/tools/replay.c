@@ -0,0 +1,364 @@
+/*
+ * replay.c - Game archive tool
+ * Converts game logs into packed archives (3 bits per move) and replays
+ * archives or logs in bulk: every record is decoded and its moves are
+ * played again to check them and to count the results.
+ *
+ * Usage: replay pack <log> <archive>        log to archive
+ *        replay check <file> [board]        replay an archive or a log,
+ *                                           board = array kernels
+ *        replay gen <archive> [games] [seed]  random games for testing
+ *
+ * pack and check exit with 1 if the input can not be read or ends in a
+ * damaged or cut-off record; the records before it are still used.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../include/gamelog.h"
+#include "../include/board.h"
+#include "../include/game.h"
+#include "../include/bitboard.h"
+#include "../include/timer.h"
+
+/* Archive bytes read at a time */
+#define READ_CHUNK (1 << 20)
+
+/* Default settings */
+#define DEFAULT_GAMES 1000000
+#define DEFAULT_SEED 1
+
+/* Replay results */
+typedef struct {
+    int boardKernel;           /* 1 = dropDisc/getGameStateAfterMove */
+    long long records;
+    long long moves;
+    long long wins[3];         /* Indexed by winner, 0 = tie */
+    long long pvp;
+    long long pvc;
+    long long invalid;         /* Illegal moves or unfinished games */
+    long long mismatched;      /* Stored winner differs from the replay */
+} ReplayTally;
+
+/* Packed records of an archive being written */
+typedef struct {
+    FILE* file;
+    long long records;
+    long long bytes;
+    int failed;                /* 1 once a write has failed */
+} ArchiveWriter;
+
+/* Replays a record with the board array functions of the game */
+static int replayOnBoard(const GameRecord* record) {
+    int board[ROWS][COLS];
+    int player = PLAYER1;
+    int state = GAME_ONGOING;
+    int row;
+    int i;
+
+    initBoard(board);
+    for (i = 0; i < record->moveCount; i++) {
+        if (state != GAME_ONGOING || record->moves[i] >= COLS) {
+            return -1;
+        }
+        row = dropDisc(board, record->moves[i], player);
+        if (row < 0) {
+            return -1;
+        }
+        state = getGameStateAfterMove(board, row, record->moves[i], player);
+        if (state == GAME_WIN) {
+            if (i != record->moveCount - 1) {
+                return -1;
+            }
+            return player;
+        }
+        player = (player == PLAYER1) ? PLAYER2 : PLAYER1;
+    }
+    return state == GAME_TIE ? EMPTY : -1;
+}
+
+/* Checks and counts one record */
+static void tallyRecord(const GameRecord* record, void* context) {
+    ReplayTally* tally = (ReplayTally*)context;
+    int result;
+
+    if (tally->boardKernel) {
+        result = replayOnBoard(record);
+    } else {
+        result = replayGameRecord(record);
+    }
+
+    tally->records++;
+    tally->moves += record->moveCount;
+    if (result < 0) {
+        tally->invalid++;
+        return;
+    }
+    if (result != record->winner) {
+        tally->mismatched++;
+    }
+    tally->wins[result]++;
+    if (record->mode == MODE_PVP) {
+        tally->pvp++;
+    } else {
+        tally->pvc++;
+    }
+}
+
+/* Writes the archive header, returns 1 on success */
+static int openArchive(ArchiveWriter* writer, const char* filename) {
+    PackedArchiveHeader header;
+
+    writer->records = 0;
+    writer->bytes = sizeof(header);
+    writer->failed = 0;
+    writer->file = fopen(filename, "wb");
+    if (writer->file == NULL) {
+        return 0;
+    }
+    header.magic = ARCHIVE_MAGIC;
+    header.version = ARCHIVE_VERSION;
+    return fwrite(&header, sizeof(header), 1, writer->file) == 1;
+}
+
+/* Appends a record to an archive */
+static void writeArchiveRecord(const GameRecord* record, void* context) {
+    ArchiveWriter* writer = (ArchiveWriter*)context;
+    unsigned char packed[PACKED_RECORD_MAX_SIZE];
+    int size = packGameRecord(record, packed);
+
+    if (fwrite(packed, 1, (size_t)size, writer->file) != (size_t)size) {
+        writer->failed = 1;
+        return;
+    }
+    writer->records++;
+    writer->bytes += size;
+}
+
+/* Closes an archive, returns 1 if every record was written */
+static int closeArchive(ArchiveWriter* writer) {
+    int closed = fclose(writer->file) == 0;
+
+    return closed && !writer->failed;
+}
+
+/* Replays every record of an archive file, returns 1 if all of it was
+ * read, 0 if it stopped early and -1 if it can not be read. A corrupt record ends the replay: without lengths there is no
+ * way to find where the next record starts. */
+static int readArchive(const char* filename, GameRecordHandler handler, void* context) {
+    static unsigned char buffer[READ_CHUNK + PACKED_RECORD_MAX_SIZE];
+    PackedArchiveHeader header;
+    GameRecord record;
+    FILE* file = fopen(filename, "rb");
+    size_t filled = 0;
+    size_t pos;
+    size_t got;
+    long long offset = sizeof(header);  /* File offset of buffer[0] */
+    int used = 0;
+
+    if (file == NULL) {
+        fprintf(stderr, "can not read %s\n", filename);
+        return -1;
+    }
+    if (fread(&header, sizeof(header), 1, file) != 1 || header.magic != ARCHIVE_MAGIC ||
+        header.version != ARCHIVE_VERSION) {
+        fprintf(stderr, "%s is not a version %d archive\n", filename, ARCHIVE_VERSION);
+        fclose(file);
+        return -1;
+    }
+
+    /* Records may cross chunk borders: the unused tail moves to the front */
+    while (used >= 0 && (got = fread(buffer + filled, 1, sizeof(buffer) - filled, file)) > 0) {
+        filled += got;
+        pos = 0;
+        while ((used = unpackGameRecord(buffer + pos, (int)(filled - pos), &record)) > 0) {
+            handler(&record, context);
+            pos += (size_t)used;
+        }
+        memmove(buffer, buffer + pos, filled - pos);
+        filled -= pos;
+        offset += (long long)pos;
+    }
+    fclose(file);
+
+    if (used < 0) {
+        fprintf(stderr, "corrupt record at byte %lld, the rest of the archive is skipped\n",
+                offset);
+        return 0;
+    }
+    if (filled > 0) {
+        fprintf(stderr, "%lu bytes of a cut-off record at the end\n", (unsigned long)filled);
+        return 0;
+    }
+    return 1;
+}
+
+/* Replays every record of a game log, returns 1 if all of it was read,
+ * 0 if it stopped early and -1 if it can not be read. Unlike the game, the tool never repairs the log, it only reports. */
+static int readLog(const char* filename, GameRecordHandler handler, void* context) {
+    FILE* file = fopen(filename, "rb");
+    long long end;
+    int tail;
+
+    if (file == NULL) {
+        fprintf(stderr, "can not read %s\n", filename);
+        return -1;
+    }
+    fclose(file);
+
+    end = readGameLog(filename, 0, handler, context);
+    tail = checkGameLogTail(filename, end);
+    if (tail == LOG_TAIL_TORN) {
+        fprintf(stderr, "cut-off record at byte %lld at the end\n", end);
+    } else if (tail == LOG_TAIL_DAMAGED) {
+        fprintf(stderr, "damaged record at byte %lld, the rest of the log is skipped\n", end);
+    }
+    return tail == LOG_TAIL_CLEAN;
+}
+
+/* Returns 1 if a file starts with the archive magic number */
+static int isArchive(const char* filename) {
+    PackedArchiveHeader header;
+    FILE* file = fopen(filename, "rb");
+    int archive = 0;
+
+    if (file != NULL) {
+        archive = fread(&header, sizeof(header), 1, file) == 1 && header.magic == ARCHIVE_MAGIC;
+        fclose(file);
+    }
+    return archive;
+}
+
+/* xorshift64* random numbers for the generated games */
+static unsigned long long nextRandom(unsigned long long* state) {
+    *state ^= *state >> 12;
+    *state ^= *state << 25;
+    *state ^= *state >> 27;
+    return *state * 2685821657736338717ULL;
+}
+
+/* Plays a random game to the end */
+static void randomGame(GameRecord* record, unsigned long long* state) {
+    Position pos;
+    int col;
+
+    memset(record, 0, sizeof(*record));
+    record->mode = MODE_PVP;
+    record->winner = EMPTY;
+    initPosition(&pos);
+    while (pos.moves < BOARD_CELLS) {
+        do {
+            col = (int)(nextRandom(state) % COLS);
+        } while (!canPlayColumn(&pos, col));
+
+        record->moves[record->moveCount++] = (unsigned char)col;
+        if (isWinningMove(&pos, col)) {
+            record->winner = (pos.moves & 1) ? PLAYER2 : PLAYER1;
+            return;
+        }
+        playColumn(&pos, col);
+    }
+}
+
+/* Prints usage */
+static void printUsage(void) {
+    fprintf(stderr, "usage: replay pack <log> <archive>\n"
+                    "       replay check <archive|log> [board]\n"
+                    "       replay gen <archive> [games] [seed]\n");
+}
+
+/* Program entry point */
+int main(int argc, char* argv[]) {
+    ArchiveWriter writer;
+    ReplayTally tally;
+    GameRecord record;
+    unsigned long long state = DEFAULT_SEED;
+    long long games = DEFAULT_GAMES;
+    long long start, elapsed;
+    long long i;
+    int complete;
+
+    if (argc < 3) {
+        printUsage();
+        return 1;
+    }
+
+    if (strcmp(argv[1], "pack") == 0 && argc > 3) {
+        if (!openArchive(&writer, argv[3])) {
+            fprintf(stderr, "can not write %s\n", argv[3]);
+            return 1;
+        }
+        complete = readLog(argv[2], writeArchiveRecord, &writer);
+        if (!closeArchive(&writer)) {
+            fprintf(stderr, "can not write %s\n", argv[3]);
+            return 1;
+        }
+        if (complete < 0) {
+            return 1;
+        }
+        printf("%lld records, %lld bytes (%.1f bytes per game)\n", writer.records, writer.bytes,
+               writer.records > 0 ? (double)writer.bytes / (double)writer.records : 0.0);
+        return complete != 1;
+    }
+
+    if (strcmp(argv[1], "gen") == 0) {
+        if (argc > 3) {
+            games = atoll(argv[3]);
+        }
+        if (argc > 4) {
+            state = strtoull(argv[4], NULL, 10);
+        }
+        if (state == 0) {
+            state = DEFAULT_SEED;
+        }
+        if (!openArchive(&writer, argv[2])) {
+            fprintf(stderr, "can not write %s\n", argv[2]);
+            return 1;
+        }
+        for (i = 0; i < games; i++) {
+            randomGame(&record, &state);
+            writeArchiveRecord(&record, &writer);
+        }
+        if (!closeArchive(&writer)) {
+            fprintf(stderr, "can not write %s\n", argv[2]);
+            return 1;
+        }
+        printf("%lld records, %lld bytes (%.1f bytes per game)\n", writer.records, writer.bytes,
+               writer.records > 0 ? (double)writer.bytes / (double)writer.records : 0.0);
+        return 0;
+    }
+
+    if (strcmp(argv[1], "check") == 0) {
+        memset(&tally, 0, sizeof(tally));
+        tally.boardKernel = argc > 3 && strcmp(argv[3], "board") == 0;
+
+        start = getTimeMicros();
+        if (isArchive(argv[2])) {
+            complete = readArchive(argv[2], tallyRecord, &tally);
+        } else {
+            complete = readLog(argv[2], tallyRecord, &tally);
+        }
+        if (complete < 0) {
+            return 1;
+        }
+        elapsed = getTimeMicros() - start;
+        if (elapsed < 1) {
+            elapsed = 1;
+        }
+
+        printf("Records   : %lld (%.1f moves per game)\n", tally.records,
+               tally.records > 0 ? (double)tally.moves / (double)tally.records : 0.0);
+        printf("Results   : %lld first player wins, %lld second player wins, %lld ties\n",
+               tally.wins[PLAYER1], tally.wins[PLAYER2], tally.wins[EMPTY]);
+        printf("Modes     : %lld PvP, %lld PvC\n", tally.pvp, tally.pvc);
+        printf("Invalid   : %lld, stored winner differs: %lld\n", tally.invalid, tally.mismatched);
+        printf("Speed     : %.0f records/sec (%s kernels, %.2f s)\n",
+               (double)tally.records * 1e6 / (double)elapsed,
+               tally.boardKernel ? "board array" : "bitboard", (double)elapsed / 1e6);
+        return complete != 1 || tally.invalid > 0 || tally.mismatched > 0;
+    }
+
+    printUsage();
+    return 1;
+}
@@ -0,0 +1,290 @@
+/*
+ * selfplay.c - Headless engine-vs-engine self-play
+ * Plays batches of games between two difficulty levels on a pool of
+ * worker threads and reports games per second and win/draw/loss tables.
+ *
+ * Engines: 1 = Easy, 2 = Medium, 3 = Hard, 4 = Perfect, 5 = Monte Carlo
+ * Engine A moves first in even games, engine B in odd games. Every game
+ * starts with a few random moves so deterministic engines do not play
+ * the same game over and over.
+ *
+ * Usage: selfplay [engineA] [engineB] [games] [threads] [hardDepth] [seed] [playouts]
+ *        hardDepth 0 uses the normal Hard time budget, playouts 0 the
+ *        normal Monte Carlo time budget
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "../include/ai.h"
+#include "../include/board.h"
+#include "../include/game.h"
+#include "../include/book.h"
+#include "../include/solver.h"
+#include "../include/transposition.h"
+#include "../include/timer.h"
+#include "../include/threads.h"
+
+/* Default settings */
+#define DEFAULT_GAMES 1000
+#define DEFAULT_THREADS 1
+#define DEFAULT_HARD_DEPTH 8
+#define DEFAULT_SEED 1
+#define DEFAULT_PLAYOUTS 10000
+
+/* Random moves at the start of every game */
+#define OPENING_PLIES 2
+
+/* Most worker threads */
+#define MAX_WORKERS 64
+
+/* Result columns, from engine A's point of view */
+#define RESULT_WIN 0
+#define RESULT_DRAW 1
+#define RESULT_LOSS 2
+
+/* Work and tallies of one worker thread */
+typedef struct {
+    int index;                  /* Worker number, plays games index, index + workers... */
+    int workers;
+    long long games;            /* Games in the whole batch */
+    unsigned long long seed;
+    int engineA;
+    int engineB;
+    long long results[2][3];    /* [A moved second][win/draw/loss] */
+    long long plies;            /* Discs dropped in all games */
+    long long playouts;         /* Monte Carlo playouts in all moves */
+    long long playoutMicros;    /* Time of the Monte Carlo moves */
+    Thread thread;
+} Worker;
+
+/* Display names of the engines */
+static const char* engineName(int engine) {
+    switch (engine) {
+        case EASY:
+            return "Easy";
+        case MEDIUM:
+            return "Medium";
+        case HARD:
+            return "Hard";
+        case PERFECT:
+            return "Perfect";
+        case MONTE_CARLO:
+            return "Monte Carlo";
+        default:
+            return "?";
+    }
+}
+
+/* Plays one game, returns the winner (PLAYER1/PLAYER2) or EMPTY for a tie */
+static int playGame(int firstEngine, int secondEngine, Worker* worker) {
+    int board[ROWS][COLS];
+    SearchInfo info;
+    int player = PLAYER1;
+    int ply;
+    int col, row;
+    int state;
+
+    initBoard(board);
+    for (ply = 0; ply < ROWS * COLS; ply++) {
+        if (ply < OPENING_PLIES) {
+            col = getRandomMove(board);
+        } else if (player == PLAYER1) {
+            col = getAIMove(board, firstEngine, player);
+        } else {
+            col = getAIMove(board, secondEngine, player);
+        }
+        if (ply >= OPENING_PLIES) {
+            getLastSearchInfo(&info);
+            worker->playouts += info.playouts;
+            if (info.playouts > 0) {
+                worker->playoutMicros += info.elapsedMicros;
+            }
+        }
+
+        row = dropDisc(board, col, player);
+        worker->plies++;
+        state = getGameStateAfterMove(board, row, col, player);
+        if (state == GAME_WIN) {
+            return player;
+        }
+        if (state == GAME_TIE) {
+            return EMPTY;
+        }
+
+        if (player == PLAYER1) {
+            player = PLAYER2;
+        } else {
+            player = PLAYER1;
+        }
+    }
+    return EMPTY;
+}
+
+/* Worker thread: plays its share of the batch with its own random seed */
+static void workerThread(void* arg) {
+    Worker* worker = (Worker*)arg;
+    long long game;
+    int aSecond;
+    int winner;
+
+    seedRandom(worker->seed + (unsigned long long)worker->index);
+
+    for (game = worker->index; game < worker->games; game += worker->workers) {
+        aSecond = (int)(game & 1);
+        if (aSecond) {
+            winner = playGame(worker->engineB, worker->engineA, worker);
+        } else {
+            winner = playGame(worker->engineA, worker->engineB, worker);
+        }
+
+        if (winner == EMPTY) {
+            worker->results[aSecond][RESULT_DRAW]++;
+        } else if ((winner == PLAYER1) != aSecond) {
+            worker->results[aSecond][RESULT_WIN]++;
+        } else {
+            worker->results[aSecond][RESULT_LOSS]++;
+        }
+    }
+    releaseMonteCarloTree();
+}
+
+/* Prints one row of the result table */
+static void printRow(const char* label, const long long counts[3]) {
+    long long total = counts[RESULT_WIN] + counts[RESULT_DRAW] + counts[RESULT_LOSS];
+    double scale = total > 0 ? 100.0 / (double)total : 0.0;
+
+    printf("  %-16s %9lld %9lld %9lld    %5.1f%% %5.1f%% %5.1f%%\n", label,
+           counts[RESULT_WIN], counts[RESULT_DRAW], counts[RESULT_LOSS],
+           counts[RESULT_WIN] * scale, counts[RESULT_DRAW] * scale, counts[RESULT_LOSS] * scale);
+}
+
+/* Program entry point */
+int main(int argc, char* argv[]) {
+    static Worker workers[MAX_WORKERS];
+    SearchLimits limits;
+    MctsLimits mctsLimits;
+    long long results[3][3] = {{0}};
+    long long games = DEFAULT_GAMES;
+    long long plies = 0;
+    long long playouts = 0;
+    long long playoutMicros = 0;
+    long long mctsPlayouts = DEFAULT_PLAYOUTS;
+    long long start, elapsed;
+    unsigned long long seed = DEFAULT_SEED;
+    int engineA = HARD;
+    int engineB = MEDIUM;
+    int threads = DEFAULT_THREADS;
+    int hardDepth = DEFAULT_HARD_DEPTH;
+    char label[32];
+    int i, j, k;
+
+    if (argc > 1) {
+        engineA = atoi(argv[1]);
+    }
+    if (argc > 2) {
+        engineB = atoi(argv[2]);
+    }
+    if (argc > 3) {
+        games = atoll(argv[3]);
+    }
+    if (argc > 4) {
+        threads = atoi(argv[4]);
+    }
+    if (argc > 5) {
+        hardDepth = atoi(argv[5]);
+    }
+    if (argc > 6) {
+        seed = strtoull(argv[6], NULL, 10);
+    }
+    if (argc > 7) {
+        mctsPlayouts = atoll(argv[7]);
+    }
+    if (engineA < EASY || engineA > MONTE_CARLO || engineB < EASY || engineB > MONTE_CARLO) {
+        fprintf(stderr, "engines must be between %d and %d\n", EASY, MONTE_CARLO);
+        return 1;
+    }
+    if (threads < 1 || threads > MAX_WORKERS) {
+        fprintf(stderr, "threads must be between 1 and %d\n", MAX_WORKERS);
+        return 1;
+    }
+
+    /* Fixed-depth Hard games are reproducible and much faster */
+    if (hardDepth > 0) {
+        getHardSearchLimits(&limits);
+        limits.maxDepth = hardDepth;
+        limits.timeLimitMs = 0;
+        limits.nodeLimit = 0;
+        limits.threads = 1;
+        setHardSearchLimits(&limits);
+    }
+
+    /* Fixed playout counts likewise */
+    if (mctsPlayouts > 0) {
+        getMonteCarloLimits(&mctsLimits);
+        mctsLimits.playoutLimit = mctsPlayouts;
+        mctsLimits.timeLimitMs = 0;
+        setMonteCarloLimits(&mctsLimits);
+    }
+
+    /* Shared tables are set up before the workers start; after that the
+     * transposition tables are lockless and the book is read-only */
+    loadOpeningBook(BOOK_FILE);
+    initTranspositionTable(TT_DEFAULT_SIZE_MB);
+    initEvaluationTables();
+    if (engineA == PERFECT || engineB == PERFECT) {
+        initSolver();
+    }
+
+    printf("Self-play: %s (A) vs %s (B), %lld games, %d threads\n",
+           engineName(engineA), engineName(engineB), games, threads);
+
+    start = getTimeMicros();
+    for (i = 0; i < threads; i++) {
+        workers[i].index = i;
+        workers[i].workers = threads;
+        workers[i].games = games;
+        workers[i].seed = seed;
+        workers[i].engineA = engineA;
+        workers[i].engineB = engineB;
+        if (!createThread(&workers[i].thread, workerThread, &workers[i])) {
+            fprintf(stderr, "Could not start worker %d\n", i);
+            return 1;
+        }
+    }
+    for (i = 0; i < threads; i++) {
+        joinThread(&workers[i].thread);
+        plies += workers[i].plies;
+        playouts += workers[i].playouts;
+        playoutMicros += workers[i].playoutMicros;
+        for (j = 0; j < 2; j++) {
+            for (k = 0; k < 3; k++) {
+                results[j][k] += workers[i].results[j][k];
+                results[2][k] += workers[i].results[j][k];
+            }
+        }
+    }
+    elapsed = getTimeMicros() - start;
+    if (elapsed < 1) {
+        elapsed = 1;
+    }
+
+    printf("Games/sec : %.1f (%.2f s, %.1f plies per game)\n",
+           (double)games * 1e6 / (double)elapsed, (double)elapsed / 1e6,
+           games > 0 ? (double)plies / (double)games : 0.0);
+    if (playouts > 0) {
+        printf("Playouts  : %lld (%.0f per second of Monte Carlo moves, per thread)\n",
+               playouts, playoutMicros > 0 ? (double)playouts * 1e6 / (double)playoutMicros : 0.0);
+    }
+    printf("\n");
+    printf("  %-16s %9s %9s %9s    %6s %6s %6s\n", "Engine A", "Wins", "Draws", "Losses",
+           "W", "D", "L");
+    sprintf(label, "%s first", engineName(engineA));
+    printRow(label, results[0]);
+    sprintf(label, "%s second", engineName(engineA));
+    printRow(label, results[1]);
+    printRow("Total", results[2]);
+
+    closeOpeningBook();
+    freeTranspositionTable();
+    return 0;
+}
@@ -0,0 +1,103 @@
+/*
+ * smpbench.c - Lazy SMP speedup benchmark
+ * Searches reference positions to a fixed depth with 1 and N threads
+ * and reports the time-to-depth speedup.
+ *
+ * Usage: smpbench [threads] [depth]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "../include/search.h"
+#include "../include/transposition.h"
+
+/* Reference positions as move strings (columns 1-7) */
+static const char* g_positions[] = {
+    "",
+    "4",
+    "44",
+    "4444",
+    "444443",
+    "4453345",
+    "3454",
+    "43442"
+};
+
+#define POSITION_COUNT ((int)(sizeof(g_positions) / sizeof(g_positions[0])))
+
+/* Builds a position from a move string, returns 0 on an illegal move */
+static int setupPosition(Position* pos, const char* moves) {
+    int col;
+
+    initPosition(pos);
+    for (; *moves != '\0'; moves++) {
+        col = *moves - '1';
+        if (!canPlayColumn(pos, col) || isWinningMove(pos, col)) {
+            return 0;
+        }
+        playColumn(pos, col);
+    }
+    return 1;
+}
+
+/* Searches every reference position, returns total time in us */
+static long long runAll(int threads, int depth, long long* nodes) {
+    SearchLimits limits;
+    SearchResult result;
+    Position pos;
+    long long total = 0;
+    int i;
+
+    limits.maxDepth = depth;
+    limits.timeLimitMs = 0;
+    limits.nodeLimit = 0;
+    limits.threads = threads;
+    limits.stop = NULL;
+
+    *nodes = 0;
+    for (i = 0; i < POSITION_COUNT; i++) {
+        if (!setupPosition(&pos, g_positions[i])) {
+            continue;
+        }
+        clearTranspositionTable();  /* Same cold start for every run */
+        searchPosition(&pos, &limits, &result);
+        total += result.elapsedMicros;
+        *nodes += result.nodes;
+        printf("  %-16s threads=%-2d move=%d score=%-5d time=%lldus first-move cutoffs=%.1f%%\n",
+               g_positions[i][0] ? g_positions[i] : "(empty)",
+               result.threads, result.bestMove + 1, result.score, result.elapsedMicros,
+               result.cutoffs > 0 ? 100.0 * (double)result.firstMoveCutoffs / (double)result.cutoffs : 0.0);
+    }
+    return total;
+}
+
+/* Program entry point */
+int main(int argc, char* argv[]) {
+    int threads = 4;
+    int depth = 12;
+    long long singleTime, multiTime;
+    long long singleNodes, multiNodes;
+
+    if (argc > 1) {
+        threads = atoi(argv[1]);
+    }
+    if (argc > 2) {
+        depth = atoi(argv[2]);
+    }
+
+    initTranspositionTable(TT_DEFAULT_SIZE_MB);
+
+    printf("Single thread, depth %d:\n", depth);
+    singleTime = runAll(1, depth, &singleNodes);
+    printf("%d threads, depth %d:\n", threads, depth);
+    multiTime = runAll(threads, depth, &multiNodes);
+
+    printf("\n1 thread : %lld us, %lld nodes\n", singleTime, singleNodes);
+    printf("%d threads: %lld us, %lld nodes\n", threads, multiTime, multiNodes);
+    if (multiTime > 0) {
+        printf("Speedup  : %.2fx\n", (double)singleTime / (double)multiTime);
+    }
+
+    freeTranspositionTable();
+    return 0;
+}